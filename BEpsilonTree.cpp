@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <stdexcept>
+#include "BEpsilonTree.h"
+
+using namespace std;
+
+TreeStats BEpsilonTree::stats;
+
+namespace {
+    using Message = BEpsilonTreeNode::Message;
+
+    bool keyBelow(const Message& message, int key) {
+        return message.key < key;
+    }
+
+    // Adds [first, last), sorted and newer than everything in `buffer`, to `buffer`, keeping
+    // one message per key.
+    void mergeMessages(vector<Message>& buffer, const Message* first, const Message* last) {
+        if (last - first == 1) {
+            auto it = lower_bound(buffer.begin(), buffer.end(), first->key, keyBelow);
+            if (it != buffer.end() && it->key == first->key) {
+                *it = *first;
+            } else {
+                buffer.insert(it, *first);
+            }
+            return;
+        }
+        vector<Message> merged;
+        merged.reserve(buffer.size() + (last - first));
+        auto it = buffer.begin();
+        for (; first != last; ++first) {
+            while (it != buffer.end() && it->key < first->key) {
+                merged.push_back(*it++);
+            }
+            if (it != buffer.end() && it->key == first->key) ++it;
+            merged.push_back(*first);
+        }
+        merged.insert(merged.end(), it, buffer.end());
+        buffer.swap(merged);
+    }
+
+    // Applies sorted messages to sorted, unique keys.
+    void applyToKeys(vector<int>& keys, const Message* first, const Message* last) {
+        if (last - first == 1) {
+            auto it = lower_bound(keys.begin(), keys.end(), first->key);
+            bool present = it != keys.end() && *it == first->key;
+            if (first->erase && present) {
+                keys.erase(it);
+            } else if (!first->erase && !present) {
+                keys.insert(it, first->key);
+            }
+            return;
+        }
+        vector<int> merged;
+        merged.reserve(keys.size() + (last - first));
+        auto it = keys.begin();
+        for (; first != last; ++first) {
+            while (it != keys.end() && *it < first->key) {
+                merged.push_back(*it++);
+            }
+            if (it != keys.end() && *it == first->key) ++it;
+            if (!first->erase) merged.push_back(first->key);
+        }
+        merged.insert(merged.end(), it, keys.end());
+        keys.swap(merged);
+    }
+
+    // Messages of node's buffer bound for children[i], as [begin, end) indexes.
+    pair<size_t, size_t> childMessages(const BEpsilonTreeNode* node, size_t i) {
+        const vector<Message>& buffer = node->buffer;
+        auto begin = i == 0 ? buffer.begin()
+                            : lower_bound(buffer.begin(), buffer.end(), node->pivots[i - 1], keyBelow);
+        auto end = i == node->pivots.size() ? buffer.end()
+                                            : lower_bound(begin, buffer.end(), node->pivots[i], keyBelow);
+        return {begin - buffer.begin(), end - buffer.begin()};
+    }
+
+    size_t heaviestChild(const BEpsilonTreeNode* node) {
+        size_t best = 0, bestCount = 0;
+        size_t pos = 0;
+        while (pos < node->buffer.size()) {
+            size_t i = node->childIndex(node->buffer[pos].key);
+            size_t end = childMessages(node, i).second;
+            if (end - pos > bestCount) {
+                best = i;
+                bestCount = end - pos;
+            }
+            pos = end;
+        }
+        return best;
+    }
+
+    void deleteNodes(BEpsilonTreeNode* node) {
+        for (BEpsilonTreeNode* child : node->children) {
+            deleteNodes(child);
+        }
+        delete node;
+    }
+
+    size_t nodeMemory(const BEpsilonTreeNode* node) {
+        size_t bytes = sizeof(BEpsilonTreeNode) + node->keys.capacity() * sizeof(int) +
+                       node->pivots.capacity() * sizeof(int) +
+                       node->children.capacity() * sizeof(BEpsilonTreeNode*) +
+                       node->buffer.capacity() * sizeof(Message);
+        for (const BEpsilonTreeNode* child : node->children) {
+            bytes += nodeMemory(child);
+        }
+        return bytes;
+    }
+
+    size_t bufferedMessages(const BEpsilonTreeNode* node) {
+        size_t count = node->buffer.size();
+        for (const BEpsilonTreeNode* child : node->children) {
+            count += bufferedMessages(child);
+        }
+        return count;
+    }
+
+    // The keys below `node` as they would be with every pending message applied.
+    void collectKeysInOrder(const BEpsilonTreeNode* node, vector<int>& out) {
+        if (node->isLeaf) {
+            out.insert(out.end(), node->keys.begin(), node->keys.end());
+            return;
+        }
+        vector<int> below;
+        for (const BEpsilonTreeNode* child : node->children) {
+            collectKeysInOrder(child, below);
+        }
+        if (!node->buffer.empty()) {
+            applyToKeys(below, node->buffer.data(), node->buffer.data() + node->buffer.size());
+        }
+        out.insert(out.end(), below.begin(), below.end());
+    }
+}
+
+size_t BEpsilonTreeNode::childIndex(int key) const {
+    return upper_bound(pivots.begin(), pivots.end(), key) - pivots.begin();
+}
+
+BEpsilonTree::BEpsilonTree(int leafKeys, int fanout, int bufferMessages)
+    : root(nullptr), leafKeys(leafKeys), fanout(fanout), bufferMessages(bufferMessages) {
+    if (leafKeys < 2 || fanout < 3 || bufferMessages < 1) {
+        throw invalid_argument("BEpsilonTree needs leafKeys >= 2, fanout >= 3 and bufferMessages >= 1");
+    }
+    root = new Node(true);
+}
+
+BEpsilonTree::~BEpsilonTree() {
+    deleteNodes(root);
+}
+
+void BEpsilonTree::insert(int key) {
+    write(key, false);
+}
+
+void BEpsilonTree::erase(int key) {
+    write(key, true);
+}
+
+void BEpsilonTree::write(int key, bool erase) {
+    Message message = {key, erase};
+    Split split;
+    apply(root, &message, &message + 1, split);
+    growRoot(split);
+}
+
+bool BEpsilonTree::contains(int key) const {
+    TREE_STAT(stats.searches++);
+    const Node* node = root;
+    while (!node->isLeaf) {
+        TREE_STAT(stats.nodesVisited++);
+        auto it = lower_bound(node->buffer.begin(), node->buffer.end(), key, keyBelow);
+        if (it != node->buffer.end() && it->key == key) return !it->erase;
+        node = node->children[node->childIndex(key)];
+    }
+    TREE_STAT(stats.nodesVisited++);
+    return binary_search(node->keys.begin(), node->keys.end(), key);
+}
+
+// Messages reaching a leaf are applied; messages reaching an internal node wait in its buffer
+// until it overflows. Nodes cut off by splits are appended to `split`.
+void BEpsilonTree::apply(Node* node, const Message* first, const Message* last, Split& split) {
+    if (node->isLeaf) {
+        applyToKeys(node->keys, first, last);
+        if (node->keys.size() > static_cast<size_t>(leafKeys)) splitLeaf(node, split);
+        return;
+    }
+    mergeMessages(node->buffer, first, last);
+    while (node->buffer.size() > static_cast<size_t>(bufferMessages)) {
+        flushChild(node, heaviestChild(node));
+    }
+    if (node->children.size() > static_cast<size_t>(fanout)) splitInternal(node, split);
+}
+
+// Moves the messages bound for children[i] into it and links in the nodes it splits into.
+void BEpsilonTree::flushChild(Node* node, size_t i) {
+    pair<size_t, size_t> range = childMessages(node, i);
+    vector<Message> batch(node->buffer.begin() + range.first, node->buffer.begin() + range.second);
+    node->buffer.erase(node->buffer.begin() + range.first, node->buffer.begin() + range.second);
+    TREE_STAT(stats.bufferFlushes++);
+    TREE_STAT(stats.messagesFlushed += batch.size());
+
+    Split childSplit;
+    apply(node->children[i], batch.data(), batch.data() + batch.size(), childSplit);
+    for (size_t j = 0; j < childSplit.size(); j++) {
+        node->pivots.insert(node->pivots.begin() + i + j, childSplit[j].first);
+        node->children.insert(node->children.begin() + i + j + 1, childSplit[j].second);
+    }
+}
+
+void BEpsilonTree::flush() {
+    Split split;
+    flushAll(root, split);
+    growRoot(split);
+}
+
+void BEpsilonTree::flushAll(Node* node, Split& split) {
+    if (node->isLeaf) return;
+    while (!node->buffer.empty()) {
+        flushChild(node, node->childIndex(node->buffer[0].key));
+    }
+    for (size_t i = 0; i < node->children.size(); i++) {
+        Split childSplit;
+        flushAll(node->children[i], childSplit);
+        for (size_t j = 0; j < childSplit.size(); j++) {
+            node->pivots.insert(node->pivots.begin() + i + j, childSplit[j].first);
+            node->children.insert(node->children.begin() + i + j + 1, childSplit[j].second);
+        }
+        i += childSplit.size();
+    }
+    if (node->children.size() > static_cast<size_t>(fanout)) splitInternal(node, split);
+}
+
+// A batch can overfill a node several times over, so both splits cut it into as many pieces as
+// leave each about half full, and never more pieces than entries; `node` keeps the first.
+void BEpsilonTree::splitLeaf(Node* node, Split& split) {
+    vector<int> keys;
+    keys.swap(node->keys);
+    size_t pieces = max<size_t>(2, min(keys.size() * 2 / leafKeys, keys.size()));
+    size_t pos = 0;
+    for (size_t p = 0; p < pieces; p++) {
+        size_t size = keys.size() / pieces + (p < keys.size() % pieces ? 1 : 0);
+        Node* piece = p == 0 ? node : new Node(true);
+        piece->keys.assign(keys.begin() + pos, keys.begin() + pos + size);
+        if (p > 0) split.emplace_back(keys[pos], piece);
+        pos += size;
+    }
+    TREE_STAT(stats.splits += pieces - 1);
+}
+
+void BEpsilonTree::splitInternal(Node* node, Split& split) {
+    vector<int> pivots;
+    vector<Node*> children;
+    vector<Message> buffer;
+    pivots.swap(node->pivots);
+    children.swap(node->children);
+    buffer.swap(node->buffer);
+
+    size_t n = children.size();
+    size_t pieces = max<size_t>(2, min(n * 2 / fanout, n));
+    size_t pos = 0, message = 0;
+    for (size_t p = 0; p < pieces; p++) {
+        size_t size = n / pieces + (p < n % pieces ? 1 : 0);
+        size_t end = pos + size;
+        size_t messageEnd = end == n ? buffer.size()
+                                     : lower_bound(buffer.begin() + message, buffer.end(), pivots[end - 1], keyBelow) -
+                                           buffer.begin();
+        Node* piece = p == 0 ? node : new Node(false);
+        piece->children.assign(children.begin() + pos, children.begin() + end);
+        piece->pivots.assign(pivots.begin() + pos, pivots.begin() + end - 1);
+        piece->buffer.assign(buffer.begin() + message, buffer.begin() + messageEnd);
+        if (p > 0) split.emplace_back(pivots[pos - 1], piece);
+        pos = end;
+        message = messageEnd;
+    }
+    TREE_STAT(stats.splits += pieces - 1);
+}
+
+// Puts a new root above the old one and the nodes split off it, until the root fits.
+void BEpsilonTree::growRoot(Split& split) {
+    while (!split.empty()) {
+        Node* top = new Node(false);
+        top->children.push_back(root);
+        for (const pair<int, Node*>& entry : split) {
+            top->pivots.push_back(entry.first);
+            top->children.push_back(entry.second);
+        }
+        root = top;
+        split.clear();
+        if (top->children.size() > static_cast<size_t>(fanout)) splitInternal(top, split);
+    }
+}
+
+size_t BEpsilonTree::keyCount() const {
+    vector<int> keys;
+    collectKeys(keys);
+    return keys.size();
+}
+
+size_t BEpsilonTree::pendingMessages() const {
+    return bufferedMessages(root);
+}
+
+int BEpsilonTree::depth() const {
+    int levels = 1;
+    for (const Node* node = root; !node->isLeaf; node = node->children[0]) {
+        levels++;
+    }
+    return levels;
+}
+
+size_t BEpsilonTree::memoryUsage() const {
+    return nodeMemory(root);
+}
+
+void BEpsilonTree::collectKeys(vector<int>& out) const {
+    collectKeysInOrder(root, out);
+}
+
+void BEpsilonTree::clear() {
+    deleteNodes(root);
+    root = new Node(true);
+}
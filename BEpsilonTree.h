@@ -0,0 +1,79 @@
+
+#ifndef FINALPROJECTV2_BEPSILONTREE_H
+#define FINALPROJECTV2_BEPSILONTREE_H
+
+#include <utility>
+#include <vector>
+#include "TreeStats.h"
+
+// Node of a BEpsilonTree. Leaves hold sorted keys. Internal nodes route with pivots, where
+// children[i] holds the keys k with pivots[i - 1] <= k < pivots[i], and keep a buffer of writes
+// not yet applied below them: sorted by key, at most one message per key (the newest).
+struct BEpsilonTreeNode {
+    struct Message {
+        int key;
+        bool erase;     // a delete; otherwise an insert
+    };
+
+    bool isLeaf;
+    std::vector<int> keys;
+    std::vector<int> pivots;
+    std::vector<BEpsilonTreeNode*> children;
+    std::vector<Message> buffer;
+
+    explicit BEpsilonTreeNode(bool isLeaf) : isLeaf(isLeaf) {}
+
+    size_t childIndex(int key) const;
+};
+
+// Write-optimised B+-Tree over int keys for insert-heavy streams. insert() and erase() do not
+// descend: they drop a message into the root's buffer. When a buffer outgrows bufferMessages, the
+// messages bound for the child with the most of them move down in one batch, so one descent and
+// one leaf rewrite are shared by many writes. A lookup checks the buffers on its way down and
+// the first message for its key, the newest, decides; without one the leaf does.
+//
+// Writes are blind, so they cannot report whether the key was present and keyCount() has to
+// walk the tree. Keys are unique, and deletes do not merge underfull nodes.
+struct BEpsilonTree {
+    using Node = BEpsilonTreeNode;
+    using Message = BEpsilonTreeNode::Message;
+
+    static TreeStats stats;
+
+    Node* root;
+    int leafKeys;           // keys per leaf before it splits
+    int fanout;             // children per internal node before it splits
+    int bufferMessages;     // pending messages per internal node before it flushes
+
+    // Throws std::invalid_argument unless leafKeys >= 2, fanout >= 3 and bufferMessages >= 1.
+    explicit BEpsilonTree(int leafKeys = 256, int fanout = 16, int bufferMessages = 1024);
+    ~BEpsilonTree();
+
+    BEpsilonTree(const BEpsilonTree&) = delete;
+    BEpsilonTree& operator=(const BEpsilonTree&) = delete;
+
+    void insert(int key);
+    void erase(int key);
+    bool contains(int key) const;
+    void flush();                   // pushes every pending message down to the leaves
+
+    size_t keyCount() const;        // O(n): collects the keys
+    size_t pendingMessages() const;
+    int depth() const;
+    size_t memoryUsage() const;     // bytes held by nodes, including spare capacity
+    void collectKeys(std::vector<int>& out) const;
+    void clear();
+
+private:
+    using Split = std::vector<std::pair<int, Node*>>;
+
+    void write(int key, bool erase);
+    void apply(Node* node, const Message* first, const Message* last, Split& split);
+    void flushChild(Node* node, size_t i);
+    void flushAll(Node* node, Split& split);
+    void splitLeaf(Node* node, Split& split);
+    void splitInternal(Node* node, Split& split);
+    void growRoot(Split& split);
+};
+
+#endif //FINALPROJECTV2_BEPSILONTREE_H
@@ -2,6 +2,477 @@
 #ifndef FINALPROJECTV2_BSTOPERATIONS_H
 #define FINALPROJECTV2_BSTOPERATIONS_H
 
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FrozenTree.h"
+#include "OpLatency.h"
+#include "TreeSnapshot.h"
+#include "TreeStats.h"
+#include "TreeTraits.h"
+
+// count is the key's multiplicity: equal keys share one node.
+template <typename Key, typename Value = NoValue>
+struct BSTNode {
+    Key key;
+    Value value;
+    int count;
+    BSTNode* left;
+    BSTNode* right;
+    BSTNode* parent;
+
+    explicit BSTNode(Key k, Value v = Value())
+            : key(std::move(k)), value(std::move(v)), count(1), left(nullptr), right(nullptr), parent(nullptr) {}
+    BSTNode(Key k, int c, BSTNode* l, BSTNode* r, BSTNode* p)
+            : key(std::move(k)), value(), count(c), left(l), right(r), parent(p) {}
+
+    std::string toString() {
+        return std::to_string(key);
+    }
+};
+
+// Unbalanced binary search tree mapping Key to Value; see TreeTraits.h for the parameters.
+// It is a multiset: inserting a key that is already present raises that node's count (the node
+// keeps its value), del() lowers it, and the in-order operations repeat a key count times.
+template <typename Key, typename Value = NoValue, typename Compare = std::less<Key>>
+struct BasicBSTree {
+    using Node = BSTNode<Key, Value>;
+
+    static inline TreeStats stats;
+
+    Node* root;
+    Node* leftmost;     // the node with the smallest key, nullptr when empty
+    Node* rightmost;    // the node with the largest key, nullptr when empty
+
+    BasicBSTree() : root(nullptr), leftmost(nullptr), rightmost(nullptr) {}
+    ~BasicBSTree() { deleteSubtree(root); }
+    BasicBSTree(const BasicBSTree&) = delete;
+    BasicBSTree& operator=(const BasicBSTree&) = delete;
+
+    Node* createNode(Key key, Value value = Value()) { return new Node(std::move(key), std::move(value)); }
+
+    // Links z into the tree and returns it; if its key is already present, that node's count
+    // goes up instead, z is deleted and the existing node is returned.
+    Node* insert(Node* z) {
+        OpLatency::Timer timer(OpLatency::BST_INSERT);
+        Node* y = nullptr;
+        Node* x = root;
+        bool onlyLeft = true, onlyRight = true;
+        while (x != nullptr) {
+            y = x;
+            if (before(z->key, x->key)) {
+                x = x->left;
+                onlyRight = false;
+            } else if (before(x->key, z->key)) {
+                x = x->right;
+                onlyLeft = false;
+            } else {
+                TREE_STAT(stats.duplicates++);
+                x->count++;
+                delete z;
+                return x;
+            }
+        }
+        z->parent = y;
+        if (y == nullptr)
+            root = z;
+        else if (before(z->key, y->key))
+            y->left = z;
+        else
+            y->right = z;
+        if (onlyLeft) leftmost = z;
+        if (onlyRight) rightmost = z;
+        return z;
+    }
+
+    Node* insert(Key key, Value value = Value()) { return insert(createNode(std::move(key), std::move(value))); }
+
+    Node* search(Node* x, const Key& key) { return timedSearch(x, key); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Node* search(Node* x, const K& key) { return timedSearch(x, key); }
+
+    // Sets results[i] to search(root, keys[i]) for every i. The probes are sorted, and each node
+    // splits the sorted run it receives into the probes below, equal to and above its key and
+    // hands the outer runs to its children, so probes with a common path share its descent and
+    // no node is visited twice in a batch. A run down to one probe finishes as a plain search.
+    void multiSearch(const std::vector<Key>& keys, std::vector<Node*>& results) {
+        results.assign(keys.size(), nullptr);
+        TREE_STAT(stats.searches += keys.size());
+        std::vector<std::pair<Key, size_t>> probes;
+        probes.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            probes.emplace_back(keys[i], i);
+        }
+        std::sort(probes.begin(), probes.end(), [](const auto& a, const auto& b) { return before(a.first, b.first); });
+
+        struct Run {
+            Node* x;
+            size_t first, last;
+        };
+        std::vector<Run> pending;
+        if (!probes.empty()) pending.push_back({root, 0, probes.size()});
+        while (!pending.empty()) {
+            Run run = pending.back();
+            pending.pop_back();
+            if (run.last - run.first == 1) {
+                results[probes[run.first].second] = searchFrom(run.x, probes[run.first].first);
+                continue;
+            }
+            if (run.x == nullptr) continue;
+            TREE_STAT(stats.nodesVisited++);
+            auto first = probes.begin() + run.first;
+            auto last = probes.begin() + run.last;
+            auto equalFirst = std::lower_bound(first, last, run.x->key,
+                                               [](const auto& probe, const Key& key) { return before(probe.first, key); });
+            auto equalLast = std::upper_bound(equalFirst, last, run.x->key,
+                                              [](const Key& key, const auto& probe) { return before(key, probe.first); });
+            for (auto it = equalFirst; it != equalLast; ++it) {
+                results[it->second] = run.x;
+            }
+            if (first != equalFirst) pending.push_back({run.x->left, run.first, size_t(equalFirst - probes.begin())});
+            if (equalLast != last) pending.push_back({run.x->right, size_t(equalLast - probes.begin()), run.last});
+        }
+    }
+
+    // The value stored under `key`, or nullptr.
+    Value* find(const Key& key) { return valueOf(search(root, key)); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value* find(const K& key) { return valueOf(search(root, key)); }
+
+    Value& at(const Key& key) { return checkedValue(find(key)); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value& at(const K& key) { return checkedValue(find(key)); }
+
+    // The smallest / largest node, in O(1) from the cached extremes; nullptr when empty.
+    Node* minimum() { return leftmost; }
+    Node* maximum() { return rightmost; }
+
+    // Removes one copy of the smallest / largest key, copying it to *key and *value when those
+    // are not null (moving them out with the last copy); false if the tree is empty. The node
+    // comes from the cached extreme, so there is no search.
+    bool popMin(Key* key = nullptr, Value* value = nullptr) { return popNode(leftmost, key, value); }
+    bool popMax(Key* key = nullptr, Value* value = nullptr) { return popNode(rightmost, key, value); }
+
+    Node* minimum(Node* x) {
+        while (x && x->left != nullptr)
+            x = x->left;
+        return x;
+    }
+
+    Node* maximum(Node* x) {
+        while (x && x->right != nullptr)
+            x = x->right;
+        return x;
+    }
+
+    Node* successor(Node* x) {
+        TREE_STAT(stats.successorWalks++);
+        if (x->right != nullptr) {
+            Node* y = x->right;
+            TREE_STAT(stats.successorSteps++);
+            while (y->left != nullptr) {
+                y = y->left;
+                TREE_STAT(stats.successorSteps++);
+            }
+            return y;
+        }
+        Node* y = x->parent;
+        while (y != nullptr && x == y->right) {
+            x = y;
+            y = y->parent;
+            TREE_STAT(stats.successorSteps++);
+        }
+        return y;
+    }
+
+    Node* predecessor(Node* x) {
+        if (x->left != nullptr)
+            return maximum(x->left);
+        Node* y = x->parent;
+        while (y != nullptr && x == y->left) {
+            x = y;
+            y = y->parent;
+        }
+        return y;
+    }
+
+    // Removes one copy of z's key; the node goes away with its last copy.
+    void del(Node* z) {
+        if (z == nullptr) return;
+        OpLatency::Timer timer(OpLatency::BST_DELETE);
+        if (z->count > 1) {
+            z->count--;
+            return;
+        }
+        // The extremes have at most one child, so they are unlinked themselves (y == z) and their
+        // in-order neighbour is that child's subtree or their parent. A successor that was the
+        // largest node hands its key to z, which takes over as the largest.
+        if (z == leftmost) leftmost = z->right != nullptr ? minimum(z->right) : z->parent;
+        if (z == rightmost) rightmost = z->left != nullptr ? maximum(z->left) : z->parent;
+        Node* y = (z->left == nullptr || z->right == nullptr) ? z : successor(z);
+        if (y != z && y == rightmost) rightmost = z;
+        Node* x = (y->left != nullptr) ? y->left : y->right;
+        if (x != nullptr)
+            x->parent = y->parent;
+        if (y->parent == nullptr)
+            root = x;
+        else if (y == y->parent->left)
+            y->parent->left = x;
+        else
+            y->parent->right = x;
+        if (y != z) {
+            z->key = std::move(y->key);
+            z->value = std::move(y->value);
+            z->count = y->count;
+        }
+        delete y;
+    }
+
+    void inorder(Node* x) {
+        if (x != nullptr) {
+            inorder(x->left);
+            for (int i = 0; i < x->count; i++) {
+                std::cout << x->toString() << " ";
+            }
+            inorder(x->right);
+        }
+    }
+
+    void inorder() { inorder(root); }
+
+    void indentedDisplay(Node* x, int indent) {
+        if (x != nullptr) {
+            indentedDisplay(x->right, indent + 4);
+            if (indent > 0)
+                std::cout << std::string(indent, ' ');
+            std::cout << x->toString();
+            if (x->count > 1)
+                std::cout << " (x" << x->count << ")";
+            std::cout << std::endl;
+            indentedDisplay(x->left, indent + 4);
+        }
+    }
+
+    void indentedDisplay() {
+        std::cout << "Binary Search Tree:\n";
+        indentedDisplay(root, 0);
+    }
+
+    int depth(Node* x) {
+        if (x == nullptr) return 0;
+        return 1 + std::max(depth(x->left), depth(x->right));
+    }
+
+    int depth() { return depth(root); }
+
+    bool isBalanced(Node* x) {
+        if (x == nullptr) return true;
+
+        int leftHeight = depth(x->left);
+        int rightHeight = depth(x->right);
+
+        return std::abs(leftHeight - rightHeight) <= 1 &&
+               isBalanced(x->left) &&
+               isBalanced(x->right);
+    }
+
+    Node* findLCA(Node* root, const Key& key1, const Key& key2) {
+        if (root == nullptr) return nullptr;
+
+        if (before(key1, root->key) && before(key2, root->key))
+            return findLCA(root->left, key1, key2);
+
+        if (before(root->key, key1) && before(root->key, key2))
+            return findLCA(root->right, key1, key2);
+
+        return root;
+    }
+
+    void kthSmallestHelper(Node* x, int& k, Node*& result) {
+        if (x == nullptr || k <= 0) return;
+
+        kthSmallestHelper(x->left, k, result);
+        if (result != nullptr) return;
+
+        k -= x->count;
+        if (k <= 0) {
+            result = x;
+            return;
+        }
+
+        kthSmallestHelper(x->right, k, result);
+    }
+
+    // The k-th smallest node (1-based), or nullptr when the tree has fewer than k nodes.
+    Node* kthSmallest(int k) {
+        OpLatency::Timer timer(OpLatency::BST_KTH);
+        Node* result = nullptr;
+        kthSmallestHelper(root, k, result);
+        return result;
+    }
+
+    Node* kthLargest(Node* root, int& k) {
+        if (root == nullptr || k <= 0) return nullptr;
+
+        Node* result = kthLargest(root->right, k);
+        if (result != nullptr) return result;
+
+        k -= root->count;
+        if (k <= 0) return root;
+
+        return kthLargest(root->left, k);
+    }
+
+    Node* kthLargest(int k) {
+        OpLatency::Timer timer(OpLatency::BST_KTH);
+        return kthLargest(root, k);
+    }
+
+    void rangeQuery(Node* root, const Key& low, const Key& high, std::list<Key>& result) {
+        if (root == nullptr) return;
+
+        if (before(low, root->key))
+            rangeQuery(root->left, low, high, result);
+
+        if (!before(root->key, low) && !before(high, root->key))
+            result.insert(result.end(), root->count, root->key);
+
+        if (before(root->key, high))
+            rangeQuery(root->right, low, high, result);
+    }
+
+    std::list<Key> rangeQuery(const Key& low, const Key& high) {
+        OpLatency::Timer timer(OpLatency::BST_RANGE);
+        std::list<Key> result;
+        rangeQuery(root, low, high, result);
+        return result;
+    }
+
+    void collectKeys(Node* x, std::vector<Key>& out) {
+        if (x != nullptr) {
+            collectKeys(x->left, out);
+            out.insert(out.end(), x->count, x->key);
+            collectKeys(x->right, out);
+        }
+    }
+
+    // Read-only copy of the current keys for search-heavy phases; see FrozenTree.h.
+    FrozenTree<Key, Compare> freeze() {
+        std::vector<Key> keys;
+        collectKeys(root, keys);
+        return FrozenTree<Key, Compare>(keys);
+    }
+
+    // Snapshots hold int keys only (TreeSnapshot.h).
+    bool save(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        collectKeys(root, keys);
+        return TreeSnapshot::write(path, TreeSnapshot::BST, keys);
+    }
+
+    bool load(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        if (!TreeSnapshot::read(path, TreeSnapshot::BST, keys))
+            return false;
+        std::vector<int> distinct;
+        std::vector<int> counts;
+        for (int key : keys) {
+            if (distinct.empty() || distinct.back() != key) {
+                distinct.push_back(key);
+                counts.push_back(0);
+            }
+            counts.back()++;
+        }
+        deleteSubtree(root);
+        root = buildBalanced(distinct, counts, 0, distinct.size(), nullptr);
+        leftmost = minimum(root);
+        rightmost = maximum(root);
+        return true;
+    }
+
+
+private:
+    template <typename A, typename B>
+    static bool before(const A& a, const B& b) { return Compare()(a, b); }
+
+    template <typename K>
+    Node* timedSearch(Node* x, const K& key) {
+        OpLatency::Timer timer(OpLatency::BST_SEARCH);
+        TREE_STAT(stats.searches++);
+        return searchFrom(x, key);
+    }
+
+    template <typename K>
+    Node* searchFrom(Node* x, const K& key) {
+        while (x != nullptr) {
+            TREE_STAT(stats.nodesVisited++; stats.comparisons++);
+            if (before(key, x->key)) {
+                x = x->left;
+            } else {
+                TREE_STAT(stats.comparisons++);
+                if (!before(x->key, key)) return x;
+                x = x->right;
+            }
+        }
+        return nullptr;
+    }
+
+    static Value* valueOf(Node* x) { return x == nullptr ? nullptr : &x->value; }
+
+    bool popNode(Node* z, Key* key, Value* value) {
+        if (z == nullptr) return false;
+        if (z->count > 1) {
+            if (key != nullptr) *key = z->key;
+            if (value != nullptr) *value = z->value;
+        } else {
+            if (key != nullptr) *key = std::move(z->key);
+            if (value != nullptr) *value = std::move(z->value);
+        }
+        del(z);
+        return true;
+    }
+
+    static Value& checkedValue(Value* value) {
+        if (value == nullptr) throw std::out_of_range("key not found");
+        return *value;
+    }
+
+    // Builds a height-balanced subtree from keys[lo, hi) without comparisons against the tree.
+    // The keys are distinct; counts[i] is the multiplicity of keys[i].
+    Node* buildBalanced(const std::vector<Key>& keys, const std::vector<int>& counts, size_t lo, size_t hi,
+                        Node* parent) {
+        if (lo >= hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        Node* x = new Node(keys[mid], counts[mid], nullptr, nullptr, parent);
+        x->left = buildBalanced(keys, counts, lo, mid, x);
+        x->right = buildBalanced(keys, counts, mid + 1, hi, x);
+        return x;
+    }
+
+    void deleteSubtree(Node* x) {
+        if (x != nullptr) {
+            deleteSubtree(x->left);
+            deleteSubtree(x->right);
+            delete x;
+        }
+    }
+};
+
+// The interactive playground and the tools built on it use int keys without payload.
+using BSTree = BasicBSTree<int>;
+using Node = BSTree::Node;
+
 void bstMenu();
 
 #endif //FINALPROJECTV2_BSTOPERATIONS_H
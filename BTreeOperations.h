@@ -2,6 +2,860 @@
 #ifndef FINALPROJECTV2_BTREEOPERATIONS_H
 #define FINALPROJECTV2_BTREEOPERATIONS_H
 
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "OpLatency.h"
+#include "TreeSnapshot.h"
+#include "TreeStats.h"
+#include "TreeTraits.h"
+
+template <typename Key, typename Value, typename Compare>
+struct BasicBTree;
+
+// values runs parallel to keys; it stays empty when the tree stores no values. counts runs
+// parallel to children: counts[i] is the number of keys in the subtree of children[i].
+template <typename Key, typename Value = NoValue, typename Compare = std::less<Key>>
+struct BasicBTreeNode {
+    std::vector<Key> keys;
+    std::vector<Value> values;
+    std::vector<BasicBTreeNode*> children;
+    std::vector<size_t> counts;
+    bool isLeaf;
+    int t;
+
+    BasicBTreeNode(int t, bool isLeaf) : isLeaf(isLeaf), t(t) {}
+
+    // Keys in this node's subtree, in O(t).
+    size_t subtreeSize() const {
+        size_t size = keys.size();
+        for (size_t count : counts) {
+            size += count;
+        }
+        return size;
+    }
+
+    void traverse() {
+        size_t i;
+        for (i = 0; i < keys.size(); i++) {
+            if (!isLeaf) {
+                children[i]->traverse();
+            }
+            std::cout << " " << keys[i];
+        }
+        if (!isLeaf) {
+            children[i]->traverse();
+        }
+    }
+
+    template <typename K>
+    BasicBTreeNode* search(const K& key) {
+        size_t i = 0;
+        while (i < keys.size() && before(keys[i], key)) {
+            i++;
+        }
+        TREE_STAT(stats().nodesVisited++; stats().comparisons += i + (i < keys.size() ? 2 : 0));
+        if (i < keys.size() && !before(key, keys[i])) {
+            return this;
+        }
+        if (isLeaf) {
+            return nullptr;
+        }
+        return children[i]->search(key);
+    }
+
+    // Index of `key` in this node; only meaningful on a node search() returned.
+    template <typename K>
+    size_t indexOf(const K& key) const {
+        return std::lower_bound(keys.begin(), keys.end(), key, Compare()) - keys.begin();
+    }
+
+    void insertNonFull(Key key, Value value) {
+        size_t i = std::upper_bound(keys.begin(), keys.end(), key, Compare()) - keys.begin();
+        if (isLeaf) {
+            keys.insert(keys.begin() + i, std::move(key));
+            if constexpr (StoresValues<Value>::value) values.insert(values.begin() + i, std::move(value));
+        } else {
+            if (children[i]->keys.size() == 2 * t - 1) {
+                splitChild(i, children[i]);
+                if (before(keys[i], key)) {
+                    i++;
+                }
+            }
+            counts[i]++;
+            children[i]->insertNonFull(std::move(key), std::move(value));
+        }
+    }
+
+    void splitChild(int i, BasicBTreeNode* y) { splitChild(i, y, t - 1); }
+
+    // Splits the full child y = children[i] around y->keys[keep]: y keeps the keys before it and
+    // the new right sibling takes the keys after it.
+    void splitChild(int i, BasicBTreeNode* y, size_t keep) {
+        TREE_STAT(stats().splits++);
+        BasicBTreeNode* z = new BasicBTreeNode(y->t, y->isLeaf);
+        moveTail(y->keys, keep + 1, z->keys);
+        if (!y->isLeaf) {
+            z->children.assign(y->children.begin() + keep + 1, y->children.end());
+            y->children.resize(keep + 1);
+            moveTail(y->counts, keep + 1, z->counts);
+        }
+        keys.insert(keys.begin() + i, std::move(y->keys.back()));
+        y->keys.pop_back();
+        if constexpr (StoresValues<Value>::value) {
+            moveTail(y->values, keep + 1, z->values);
+            values.insert(values.begin() + i, std::move(y->values.back()));
+            y->values.pop_back();
+        }
+        children.insert(children.begin() + i + 1, z);
+        size_t zSize = z->subtreeSize();
+        counts[i] -= zSize + 1;
+        counts.insert(counts.begin() + i + 1, zSize);
+    }
+
+    // Removes one entry equivalent to `key` from this subtree; its value is moved to *removed
+    // when that is not null. False if the subtree holds no such key.
+    bool removeKey(const Key& key, Value* removed = nullptr) {
+        size_t idx = 0;
+        while (idx < keys.size() && before(keys[idx], key)) {
+            idx++;
+        }
+
+        if (idx < keys.size() && !before(key, keys[idx])) {
+            if (isLeaf) {
+                removeFromLeaf(idx, removed);
+            } else {
+                removeFromNonLeaf(idx, removed);
+            }
+            return true;
+        }
+        if (isLeaf) {
+            return false;
+        }
+
+        bool flag = (idx == keys.size());
+        if (children[idx]->keys.size() < t) {
+            fill(idx);
+        }
+        if (flag && idx > keys.size()) {
+            idx--;
+        }
+        if (!children[idx]->removeKey(key, removed)) {
+            return false;
+        }
+        counts[idx]--;
+        return true;
+    }
+
+    void removeFromLeaf(int idx, Value* removed) {
+        keys.erase(keys.begin() + idx);
+        if constexpr (StoresValues<Value>::value) {
+            if (removed != nullptr) *removed = std::move(values[idx]);
+            values.erase(values.begin() + idx);
+        }
+    }
+
+    // The replacement entry is removed from the child first and its value lands straight in
+    // this node's slot, so with duplicate keys no moved-from value is left behind.
+    void removeFromNonLeaf(int idx, Value* removed) {
+        if (children[idx]->keys.size() >= t) {
+            Key pred = getPred(idx);
+            children[idx]->removeKey(pred, takeValue(idx, removed));
+            counts[idx]--;
+            keys[idx] = std::move(pred);
+        } else if (children[idx + 1]->keys.size() >= t) {
+            Key succ = getSucc(idx);
+            children[idx + 1]->removeKey(succ, takeValue(idx, removed));
+            counts[idx + 1]--;
+            keys[idx] = std::move(succ);
+        } else {
+            Key key = keys[idx];
+            merge(idx);
+            children[idx]->removeKey(key, removed);
+            counts[idx]--;
+        }
+    }
+
+    Key getPred(int idx) {
+        BasicBTreeNode* cur = children[idx];
+        while (!cur->isLeaf) {
+            cur = cur->children[cur->keys.size()];
+        }
+        return cur->keys.back();
+    }
+
+    Key getSucc(int idx) {
+        BasicBTreeNode* cur = children[idx + 1];
+        while (!cur->isLeaf) {
+            cur = cur->children[0];
+        }
+        return cur->keys[0];
+    }
+
+    void fill(int idx) {
+        if (idx != 0 && children[idx - 1]->keys.size() >= t) {
+            borrowFromPrev(idx);
+        } else if (idx != keys.size() && children[idx + 1]->keys.size() >= t) {
+            borrowFromNext(idx);
+        } else {
+            if (idx != keys.size()) {
+                merge(idx);
+            } else {
+                merge(idx - 1);
+            }
+        }
+    }
+
+    void borrowFromPrev(int idx) {
+        TREE_STAT(stats().borrowsFromPrev++);
+        BasicBTreeNode* child = children[idx];
+        BasicBTreeNode* sibling = children[idx - 1];
+
+        size_t moved = 1;
+        child->keys.insert(child->keys.begin(), std::move(keys[idx - 1]));
+        if (!child->isLeaf) {
+            child->children.insert(child->children.begin(), sibling->children.back());
+            sibling->children.pop_back();
+            moved += sibling->counts.back();
+            child->counts.insert(child->counts.begin(), sibling->counts.back());
+            sibling->counts.pop_back();
+        }
+        counts[idx] += moved;
+        counts[idx - 1] -= moved;
+        keys[idx - 1] = std::move(sibling->keys.back());
+        sibling->keys.pop_back();
+        if constexpr (StoresValues<Value>::value) {
+            child->values.insert(child->values.begin(), std::move(values[idx - 1]));
+            values[idx - 1] = std::move(sibling->values.back());
+            sibling->values.pop_back();
+        }
+    }
+
+    void borrowFromNext(int idx) {
+        TREE_STAT(stats().borrowsFromNext++);
+        BasicBTreeNode* child = children[idx];
+        BasicBTreeNode* sibling = children[idx + 1];
+
+        size_t moved = 1;
+        child->keys.push_back(std::move(keys[idx]));
+        if (!child->isLeaf) {
+            child->children.push_back(sibling->children[0]);
+            moved += sibling->counts[0];
+            child->counts.push_back(sibling->counts[0]);
+        }
+        keys[idx] = std::move(sibling->keys[0]);
+        sibling->keys.erase(sibling->keys.begin());
+        if (!sibling->isLeaf) {
+            sibling->children.erase(sibling->children.begin());
+            sibling->counts.erase(sibling->counts.begin());
+        }
+        counts[idx] += moved;
+        counts[idx + 1] -= moved;
+        if constexpr (StoresValues<Value>::value) {
+            child->values.push_back(std::move(values[idx]));
+            values[idx] = std::move(sibling->values[0]);
+            sibling->values.erase(sibling->values.begin());
+        }
+    }
+
+    void merge(int idx) {
+        TREE_STAT(stats().merges++);
+        BasicBTreeNode* child = children[idx];
+        BasicBTreeNode* sibling = children[idx + 1];
+
+        child->keys.push_back(std::move(keys[idx]));
+        moveTail(sibling->keys, 0, child->keys);
+        if (!child->isLeaf) {
+            child->children.insert(child->children.end(), sibling->children.begin(), sibling->children.end());
+            child->counts.insert(child->counts.end(), sibling->counts.begin(), sibling->counts.end());
+        }
+        counts[idx] += counts[idx + 1] + 1;
+        counts.erase(counts.begin() + idx + 1);
+        keys.erase(keys.begin() + idx);
+        if constexpr (StoresValues<Value>::value) {
+            child->values.push_back(std::move(values[idx]));
+            moveTail(sibling->values, 0, child->values);
+            values.erase(values.begin() + idx);
+        }
+        children.erase(children.begin() + idx + 1);
+        delete sibling;
+    }
+
+    void displayIndented(int depth) {
+        for (int i = depth; i > 0; i--) {
+            std::cout << "    ";
+        }
+        for (const Key& key : keys) {
+            std::cout << key << " ";
+        }
+        std::cout << std::endl;
+        if (!isLeaf) {
+            for (BasicBTreeNode* child : children) {
+                child->displayIndented(depth + 1);
+            }
+        }
+    }
+
+private:
+    template <typename A, typename B>
+    static bool before(const A& a, const B& b) { return Compare()(a, b); }
+
+    static TreeStats& stats() { return BasicBTree<Key, Value, Compare>::stats; }
+
+    // Hands values[idx] to *removed and returns the emptied slot for the replacement value.
+    Value* takeValue(int idx, Value* removed) {
+        if constexpr (StoresValues<Value>::value) {
+            if (removed != nullptr) *removed = std::move(values[idx]);
+            return &values[idx];
+        } else {
+            return nullptr;
+        }
+    }
+
+    // Appends from[pos..] to `to` and truncates `from` at pos.
+    template <typename T>
+    static void moveTail(std::vector<T>& from, size_t pos, std::vector<T>& to) {
+        to.insert(to.end(), std::make_move_iterator(from.begin() + pos), std::make_move_iterator(from.end()));
+        from.erase(from.begin() + pos, from.end());
+    }
+};
+
+// B-Tree of minimum degree t mapping Key to Value; see TreeTraits.h for the parameters.
+template <typename Key, typename Value = NoValue, typename Compare = std::less<Key>>
+struct BasicBTree {
+    using Node = BasicBTreeNode<Key, Value, Compare>;
+    using KeyType = Key;
+    using CompareType = Compare;
+
+    static inline TreeStats stats;
+
+    Node* root;
+    int t;
+    // The first and last leaf, or nullptr until firstLeaf() / lastLeaf() look them up again.
+    // Splits keep the left half in the old node and merges delete the right one, so the first
+    // leaf only changes when the tree is emptied; the last one is dropped by any operation
+    // that may split or merge it.
+    Node* leftmostLeaf;
+    Node* rightmostLeaf;
+
+    BasicBTree(int t) : root(nullptr), t(t), leftmostLeaf(nullptr), rightmostLeaf(nullptr) {}
+    ~BasicBTree() { clear(); }
+    BasicBTree(const BasicBTree&) = delete;
+    BasicBTree& operator=(const BasicBTree&) = delete;
+
+    void traverse() { if (root != nullptr) root->traverse(); }
+
+    Node* search(const Key& key) { return timedSearch(key); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Node* search(const K& key) { return timedSearch(key); }
+
+    // Lookups searchBatch() keeps in flight.
+    static constexpr size_t SEARCH_BATCH_WIDTH = 16;
+
+    // Sets results[i] to search(keys[i]) for every i, interleaving the lookups (AMAC): each one
+    // is a small state machine whose steps prefetch what its next step reads and then hand over
+    // to the next of up to SEARCH_BATCH_WIDTH lookups in flight, so their cache misses overlap
+    // instead of following each other. A level is three dependent loads - the node, its keys,
+    // the child pointer - and each gets its own step.
+    void searchBatch(const std::vector<Key>& keys, std::vector<Node*>& results) {
+        results.assign(keys.size(), nullptr);
+        if (root == nullptr || keys.empty()) return;
+        TREE_STAT(stats.searches += keys.size());
+
+        enum Step { READ_NODE, SEARCH_KEYS, FOLLOW_CHILD, DONE };
+        struct Lookup {
+            size_t index;
+            Node* node;
+            Node* const* child;
+            Step step;
+        };
+        Lookup lookups[SEARCH_BATCH_WIDTH];
+        size_t next = 0;
+        size_t width = std::min(keys.size(), SEARCH_BATCH_WIDTH);
+        for (; next < width; next++) {
+            lookups[next] = {next, root, nullptr, READ_NODE};
+        }
+
+        size_t active = width;
+        for (size_t i = 0; active > 0; i = (i + 1 == width) ? 0 : i + 1) {
+            Lookup& lookup = lookups[i];
+            switch (lookup.step) {
+                case READ_NODE:
+                    prefetchLines(lookup.node->keys.data(), lookup.node->keys.size() * sizeof(Key));
+                    lookup.step = SEARCH_KEYS;
+                    break;
+                case SEARCH_KEYS: {
+                    TREE_STAT(stats.nodesVisited++);
+                    const Node* node = lookup.node;
+                    size_t pos = node->indexOf(keys[lookup.index]);
+                    if (pos < node->keys.size() && !Compare()(keys[lookup.index], node->keys[pos])) {
+                        results[lookup.index] = lookup.node;
+                    } else if (!node->isLeaf) {
+                        lookup.child = &node->children[pos];
+                        prefetchLines(lookup.child, sizeof(Node*));
+                        lookup.step = FOLLOW_CHILD;
+                        break;
+                    }
+                    if (next < keys.size()) {
+                        lookup = {next++, root, nullptr, READ_NODE};
+                    } else {
+                        lookup.step = DONE;
+                        active--;
+                    }
+                    break;
+                }
+                case FOLLOW_CHILD:
+                    lookup.node = *lookup.child;
+                    prefetchLines(lookup.node, sizeof(Node));
+                    lookup.step = READ_NODE;
+                    break;
+                case DONE:
+                    break;
+            }
+        }
+    }
+
+    // The value stored under `key`, or nullptr.
+    Value* find(const Key& key) { return valueOf(search(key), key); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value* find(const K& key) { return valueOf(search(key), key); }
+
+    Value& at(const Key& key) { return checkedValue(find(key)); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value& at(const K& key) { return checkedValue(find(key)); }
+
+    // A key not below the current maximum is an append: it goes straight into the cached
+    // rightmost leaf, and only a full leaf sends it down the right spine (see append()). Any
+    // other insert takes the usual top-down path.
+    void insert(Key key, Value value = Value()) {
+        OpLatency::Timer timer(OpLatency::BTREE_INSERT);
+        if (root != nullptr) {
+            Node* last = lastLeaf();
+            if (!Compare()(key, last->keys.back())) {
+                if (last->keys.size() < 2 * t - 1) {
+                    last->keys.push_back(std::move(key));
+                    if constexpr (StoresValues<Value>::value) last->values.push_back(std::move(value));
+                    countOnEdge(false, 1);
+                } else {
+                    append(std::move(key), std::move(value));
+                }
+                return;
+            }
+            if (last->keys.size() == 2 * t - 1) rightmostLeaf = nullptr;    // the descent may split it
+        }
+        if (root == nullptr) {
+            root = new Node(t, true);
+            root->insertNonFull(std::move(key), std::move(value));
+        } else {
+            if (root->keys.size() == 2 * t - 1) {
+                Node* s = newRootAbove(root);
+                s->splitChild(0, root);
+                int i = Compare()(s->keys[0], key) ? 1 : 0;
+                s->counts[i]++;
+                s->children[i]->insertNonFull(std::move(key), std::move(value));
+                root = s;
+            } else {
+                root->insertNonFull(std::move(key), std::move(value));
+            }
+        }
+    }
+
+    // Removes one entry equivalent to `key`, rebalancing on the way down; false if there is none.
+    bool deleteKey(const Key& key) {
+        if (!root) return false;
+        OpLatency::Timer timer(OpLatency::BTREE_DELETE);
+        dropLastLeafIfMergeable();
+        bool removed = root->removeKey(key);
+        shrinkRoot();
+        return removed;
+    }
+
+    // Removes one entry with the smallest / largest key, moving it to *key and *value when those
+    // are not null; false if the tree is empty. The entry comes from the cached first / last
+    // leaf. A leaf above the minimum fill loses it in place; otherwise it goes through
+    // deleteKey()'s descent, which then only follows the tree's outer edge.
+    bool popMin(Key* key = nullptr, Value* value = nullptr) {
+        if (root == nullptr) return false;
+        OpLatency::Timer timer(OpLatency::BTREE_DELETE);
+        Node* first = firstLeaf();
+        if (first == root || first->keys.size() >= t) {
+            if (key != nullptr) *key = std::move(first->keys.front());
+            first->removeFromLeaf(0, value);
+            countOnEdge(true, -1);
+            shrinkRoot();
+        } else {
+            popThroughDescent(first->keys.front(), key, value);
+        }
+        return true;
+    }
+
+    bool popMax(Key* key = nullptr, Value* value = nullptr) {
+        if (root == nullptr) return false;
+        OpLatency::Timer timer(OpLatency::BTREE_DELETE);
+        Node* last = lastLeaf();
+        if (last == root || last->keys.size() >= t) {
+            if (key != nullptr) *key = std::move(last->keys.back());
+            last->removeFromLeaf(last->keys.size() - 1, value);
+            countOnEdge(false, -1);
+            shrinkRoot();
+        } else {
+            popThroughDescent(last->keys.back(), key, value);
+        }
+        return true;
+    }
+
+    void displayIndented() {
+        if (root != nullptr) root->displayIndented(0);
+    }
+
+    int depth() { return calculateDepth(root); }
+    int keyCount() { return calculateKeyCount(root); }
+    int countLeafNodes() { return calculateLeafNodes(root); }
+
+    // Order statistics from the subtree counts, each one descent visiting O(t) entries per level.
+    // size() is the number of keys; rank(key) counts the keys ordered before `key`;
+    // select(k) is the k-th smallest key (0-based), or nullptr when k >= size(); countRange(low,
+    // high) counts the keys in [low, high]. Duplicates count once per copy.
+    size_t size() const { return root == nullptr ? 0 : root->subtreeSize(); }
+
+    size_t rank(const Key& key) const { return countBefore(key, false); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    size_t rank(const K& key) const { return countBefore(key, false); }
+
+    const Key* select(size_t k) const {
+        if (k >= size()) return nullptr;
+        const Node* node = root;
+        while (!node->isLeaf) {
+            size_t i = 0;
+            while (k >= node->counts[i]) {
+                k -= node->counts[i];
+                if (k == 0) return &node->keys[i];
+                k--;
+                i++;
+            }
+            node = node->children[i];
+        }
+        return &node->keys[k];
+    }
+
+    size_t countRange(const Key& low, const Key& high) const {
+        if (Compare()(high, low)) return 0;
+        return countBefore(high, true) - countBefore(low, false);
+    }
+
+    // The smallest / largest key, or nullptr when the tree is empty. O(1) while the first / last
+    // leaf is cached.
+    const Key* findMinimumKey() {
+        if (root == nullptr) return nullptr;
+        return &firstLeaf()->keys.front();
+    }
+
+    const Key* findMaximumKey() {
+        if (root == nullptr) return nullptr;
+        return &lastLeaf()->keys.back();
+    }
+
+    void collectKeys(std::vector<Key>& out) {
+        out.reserve(out.size() + size());
+        collectKeysInOrder(root, out);
+    }
+
+    // Bulk-loads sorted keys bottom-up in linear time. Each level is cut into
+    // k = ceil((n + 1) / 2t) nodes of near-equal size with one separator between neighbours;
+    // that choice keeps every node within [t - 1, 2t - 1] keys. The separators form the next
+    // level up until they fit in a single root. Only for trees without values.
+    void buildFromSorted(const std::vector<Key>& keys) {
+        static_assert(!StoresValues<Value>::value, "buildFromSorted loads keys only");
+        clear();
+        if (keys.empty()) return;
+
+        std::vector<Key> level = keys;
+        std::vector<Node*> children;
+        std::vector<size_t> sizes;      // subtree sizes of `children`
+        while (true) {
+            size_t n = level.size();
+            size_t k = (n + 2 * t) / (2 * t);
+            if (k <= 1) {
+                root = new Node(t, children.empty());
+                root->keys = std::move(level);
+                root->children = std::move(children);
+                root->counts = std::move(sizes);
+                return;
+            }
+
+            size_t base = (n - (k - 1)) / k;
+            size_t extra = (n - (k - 1)) % k;
+            std::vector<Key> separators;
+            std::vector<Node*> nodes;
+            std::vector<size_t> nodeSizes;
+            separators.reserve(k - 1);
+            nodes.reserve(k);
+            nodeSizes.reserve(k);
+            size_t pos = 0;
+            size_t childPos = 0;
+            for (size_t i = 0; i < k; i++) {
+                size_t size = base + (i < extra ? 1 : 0);
+                Node* node = new Node(t, children.empty());
+                node->keys.assign(level.begin() + pos, level.begin() + pos + size);
+                pos += size;
+                if (!children.empty()) {
+                    node->children.assign(children.begin() + childPos, children.begin() + childPos + size + 1);
+                    node->counts.assign(sizes.begin() + childPos, sizes.begin() + childPos + size + 1);
+                    childPos += size + 1;
+                }
+                nodes.push_back(node);
+                nodeSizes.push_back(node->subtreeSize());
+                if (i + 1 < k) {
+                    separators.push_back(level[pos++]);
+                }
+            }
+            level.swap(separators);
+            children.swap(nodes);
+            sizes.swap(nodeSizes);
+        }
+    }
+
+    void clear() {
+        deleteBTreeNodes(root);
+        root = nullptr;
+        leftmostLeaf = nullptr;
+        rightmostLeaf = nullptr;
+    }
+
+    // Snapshots hold int keys only (TreeSnapshot.h).
+    bool save(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        collectKeys(keys);
+        return TreeSnapshot::write(path, TreeSnapshot::BTREE, keys);
+    }
+
+    bool load(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        if (!TreeSnapshot::read(path, TreeSnapshot::BTREE, keys)) {
+            return false;
+        }
+        buildFromSorted(keys);
+        return true;
+    }
+
+
+private:
+    Node* firstLeaf() {
+        if (leftmostLeaf == nullptr) {
+            leftmostLeaf = root;
+            while (!leftmostLeaf->isLeaf) {
+                leftmostLeaf = leftmostLeaf->children.front();
+            }
+        }
+        return leftmostLeaf;
+    }
+
+    Node* lastLeaf() {
+        if (rightmostLeaf == nullptr) {
+            rightmostLeaf = root;
+            while (!rightmostLeaf->isLeaf) {
+                rightmostLeaf = rightmostLeaf->children.back();
+            }
+        }
+        return rightmostLeaf;
+    }
+
+    // Keys a full node on the right spine keeps when it splits: about 90%, since appends only
+    // ever fill its new right sibling. A 50/50 split would leave every node behind the append
+    // point half empty for good. The sibling gets at least one key.
+    size_t appendSplitPoint() const {
+        size_t full = 2 * t - 1;
+        return std::min(full * 9 / 10, full - 2);
+    }
+
+    // Appends to a full rightmost leaf: walks the right spine from the root and splits every
+    // full node on it 90/10, so the leaf and its ancestors all have room.
+    void append(Key key, Value value) {
+        size_t keep = appendSplitPoint();
+        if (root->keys.size() == 2 * t - 1) {
+            Node* s = newRootAbove(root);
+            s->splitChild(0, root, keep);
+            root = s;
+        }
+        Node* node = root;
+        while (!node->isLeaf) {
+            Node* child = node->children.back();
+            if (child->keys.size() == 2 * t - 1) {
+                node->splitChild(node->keys.size(), child, keep);
+                child = node->children.back();
+            }
+            node->counts.back()++;
+            node = child;
+        }
+        node->keys.push_back(std::move(key));
+        if constexpr (StoresValues<Value>::value) node->values.push_back(std::move(value));
+        rightmostLeaf = node;
+    }
+
+    // A new root with `child` as its only child, ready for splitChild().
+    Node* newRootAbove(Node* child) {
+        Node* s = new Node(t, false);
+        s->children.push_back(child);
+        s->counts.push_back(child->subtreeSize());
+        return s;
+    }
+
+    // Adds `delta` to the counts along the left (first) or right edge, after a key was added to
+    // or taken from the first or last leaf in place.
+    void countOnEdge(bool first, int delta) {
+        for (Node* x = root; !x->isLeaf; x = first ? x->children.front() : x->children.back()) {
+            (first ? x->counts.front() : x->counts.back()) += delta;
+        }
+    }
+
+    // The keys ordered before `key`, or not after it when `inclusive`. Every child left of the
+    // descent holds only such keys and is counted whole.
+    template <typename K>
+    size_t countBefore(const K& key, bool inclusive) const {
+        size_t count = 0;
+        for (const Node* node = root; node != nullptr;) {
+            auto end = inclusive ? std::upper_bound(node->keys.begin(), node->keys.end(), key, Compare())
+                                 : std::lower_bound(node->keys.begin(), node->keys.end(), key, Compare());
+            size_t i = end - node->keys.begin();
+            count += i;
+            if (node->isLeaf) break;
+            for (size_t j = 0; j < i; j++) {
+                count += node->counts[j];
+            }
+            node = node->children[i];
+        }
+        return count;
+    }
+
+    // A delete only merges away nodes that held fewer than t keys when it started, so a last
+    // leaf with t keys or more is still the last leaf afterwards.
+    void dropLastLeafIfMergeable() {
+        if (rightmostLeaf != nullptr && rightmostLeaf->keys.size() < t) rightmostLeaf = nullptr;
+    }
+
+    void popThroughDescent(Key extreme, Key* key, Value* value) {
+        dropLastLeafIfMergeable();
+        root->removeKey(extreme, value);
+        shrinkRoot();
+        if (key != nullptr) *key = std::move(extreme);
+    }
+
+    // Drops empty roots left behind by merges or by removing the last key.
+    void shrinkRoot() {
+        while (root != nullptr && root->keys.empty()) {
+            Node* oldRoot = root;
+            root = root->isLeaf ? nullptr : root->children[0];
+            delete oldRoot;
+        }
+        if (root == nullptr) {
+            leftmostLeaf = nullptr;
+            rightmostLeaf = nullptr;
+        }
+    }
+
+    template <typename K>
+    Node* timedSearch(const K& key) {
+        OpLatency::Timer timer(OpLatency::BTREE_SEARCH);
+        TREE_STAT(stats.searches++);
+        return (root == nullptr) ? nullptr : root->search(key);
+    }
+
+    template <typename K>
+    static Value* valueOf(Node* node, const K& key) {
+        static_assert(StoresValues<Value>::value, "the tree stores no values");
+        return node == nullptr ? nullptr : &node->values[node->indexOf(key)];
+    }
+
+    static Value& checkedValue(Value* value) {
+        if (value == nullptr) throw std::out_of_range("key not found");
+        return *value;
+    }
+
+    static void prefetchLines(const void* start, size_t bytes) {
+        const char* p = static_cast<const char*>(start);
+        for (size_t offset = 0; offset < bytes; offset += 64) {
+            __builtin_prefetch(p + offset);
+        }
+        if (bytes > 0) __builtin_prefetch(p + bytes - 1);
+    }
+
+    static int calculateLeafNodes(Node* node) {
+        if (node == nullptr) return 0;
+
+        if (node->isLeaf) return 1;
+
+        int count = 0;
+        for (Node* child : node->children) {
+            count += calculateLeafNodes(child);
+        }
+
+        return count;
+    }
+
+    static int calculateKeyCount(Node* node) {
+        if (node == nullptr) return 0;
+
+        int count = node->keys.size();
+
+        for (Node* child : node->children) {
+            count += calculateKeyCount(child);
+        }
+
+        return count;
+    }
+
+    static void collectKeysInOrder(Node* node, std::vector<Key>& out) {
+        if (node == nullptr) return;
+
+        size_t i;
+        for (i = 0; i < node->keys.size(); i++) {
+            if (!node->isLeaf) {
+                collectKeysInOrder(node->children[i], out);
+            }
+            out.push_back(node->keys[i]);
+        }
+        if (!node->isLeaf) {
+            collectKeysInOrder(node->children[i], out);
+        }
+    }
+
+    static void deleteBTreeNodes(Node* node) {
+        if (node == nullptr) return;
+
+        for (Node* child : node->children) {
+            deleteBTreeNodes(child);
+        }
+        delete node;
+    }
+
+    static int calculateDepth(Node* node) {
+        if (node == nullptr) return 0;
+
+        int maxChildDepth = 0;
+
+        for (Node* child : node->children) {
+            maxChildDepth = std::max(maxChildDepth, calculateDepth(child));
+        }
+
+        return 1 + maxChildDepth;
+    }
+};
+
+// The interactive playground and the tools built on it use int keys without payload.
+using BTree = BasicBTree<int>;
+using BTreeNode = BTree::Node;
+
 void bTreeMenu();
 
 #endif //FINALPROJECTV2_BTREEOPERATIONS_H
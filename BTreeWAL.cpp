@@ -0,0 +1,320 @@
+#include <filesystem>
+#include <stdexcept>
+#include "BTreeWAL.h"
+#include "Checksum.h"
+#include "TreeSnapshot.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    // Log record: lsn (8) | op (1) | key (4) | crc32 of the first 13 bytes (4), all little-endian.
+    const unsigned char OP_INSERT = 1;
+    const unsigned char OP_DELETE = 2;
+    const size_t RECORD_SIZE = 17;
+
+    void putU32(vector<unsigned char>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    void putU64(vector<unsigned char>& out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+        }
+    }
+
+    uint32_t getU32(const unsigned char* p) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) {
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    uint64_t getU64(const unsigned char* p) {
+        uint64_t value = 0;
+        for (int i = 7; i >= 0; --i) {
+            value = (value << 8) | p[i];
+        }
+        return value;
+    }
+
+    bool syncFile(FILE* file) {
+        if (fflush(file) != 0) return false;
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    // Makes a rename or file creation inside the directory durable.
+    void syncDirectory(const string& path) {
+#ifndef _WIN32
+        filesystem::path dir = filesystem::path(path).parent_path();
+        int fd = open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            close(fd);
+        }
+#endif
+    }
+}
+
+DurableBTree::DurableBTree(int t, const string& basePath, WALOptions options)
+        : btree(t), options(options), logPath(basePath + ".wal"), checkpointPath(basePath + ".ckpt"),
+          logFile(nullptr), flushing(false), failed(false), nextLSN(0), durableLSN(0), sinceCheckpoint(0),
+          checkpointDue(options.checkpointInterval) {
+    recover();
+}
+
+DurableBTree::~DurableBTree() {
+    if (logFile != nullptr) {
+        fclose(logFile);
+    }
+}
+
+// Both writes change the tree before logging, so the log order matches the order in which
+// concurrent writers saw the tree. If their record never becomes durable, commit() has already
+// rolled the change back.
+void DurableBTree::insert(int key) {
+    unique_lock<mutex> lock(mtx);
+    checkUsable();
+    btree.insert(key);
+    if (!commit(lock, append(OP_INSERT, key))) {
+        throw runtime_error("write-ahead log write failed: " + logPath);
+    }
+}
+
+bool DurableBTree::deleteKey(int key) {
+    unique_lock<mutex> lock(mtx);
+    checkUsable();
+    if (!btree.deleteKey(key)) {
+        return false;
+    }
+    if (!commit(lock, append(OP_DELETE, key))) {
+        throw runtime_error("write-ahead log write failed: " + logPath);
+    }
+    return true;
+}
+
+bool DurableBTree::contains(int key) {
+    lock_guard<mutex> lock(mtx);
+    return btree.search(key) != nullptr;
+}
+
+void DurableBTree::checkpoint() {
+    unique_lock<mutex> lock(mtx);
+    checkpointLocked(lock, 0);
+    checkUsable();      // checkpointLocked() skips a failed log
+}
+
+WALStats DurableBTree::stats() {
+    lock_guard<mutex> lock(mtx);
+    return counters;
+}
+
+// After a failed log write the log may hold part of a batch the writers were told had failed,
+// so nothing more is written to it; the tree stays readable.
+void DurableBTree::checkUsable() {
+    if (failed) {
+        throw runtime_error("write-ahead log failed earlier: " + logPath);
+    }
+}
+
+uint64_t DurableBTree::append(unsigned char op, int key) {
+    uint64_t lsn = ++nextLSN;
+    size_t start = pending.size();
+    putU64(pending, lsn);
+    pending.push_back(op);
+    putU32(pending, static_cast<uint32_t>(key));
+    putU32(pending, Checksum::crc32(pending.data() + start, RECORD_SIZE - 4));
+    ++sinceCheckpoint;
+    return lsn;
+}
+
+// Returns true once record `lsn` is on stable storage, false if the write failed. In
+// group-commit mode the first waiter becomes the leader: it takes every record appended so
+// far, writes and fsyncs them with the lock released, and wakes the followers whose records
+// were part of that batch. A failed write is rolled back here, by the thread that saw it, so
+// the followers only report the failure. A failed automatic checkpoint does not fail the
+// write, which is already durable; it is counted and retried `checkpointInterval` records later.
+bool DurableBTree::commit(unique_lock<mutex>& lock, uint64_t lsn) {
+    if (options.syncMode == WALSyncMode::PerOperation) {
+        if (!writeAndSync(pending)) {
+            rollback(pending);
+            pending.clear();
+            failed = true;
+            return false;
+        }
+        ++counters.syncs;
+        pending.clear();
+        durableLSN = lsn;
+    } else {
+        while (durableLSN < lsn) {
+            if (failed) {
+                return false;
+            }
+            if (flushing) {
+                flushed.wait(lock);
+                continue;
+            }
+
+            flushing = true;
+            writing.swap(pending);
+            uint64_t batchEnd = nextLSN;
+            lock.unlock();
+            bool ok = writeAndSync(writing);
+            lock.lock();
+
+            flushing = false;
+            if (ok) {
+                ++counters.syncs;
+                durableLSN = batchEnd;
+            } else {
+                rollback(pending);      // appended while the batch was being written
+                rollback(writing);
+                pending.clear();
+                failed = true;
+            }
+            writing.clear();
+            flushed.notify_all();
+        }
+    }
+
+    if (options.checkpointInterval != 0 && sinceCheckpoint >= checkpointDue) {
+        try {
+            checkpointLocked(lock, checkpointDue);
+        } catch (const exception&) {
+            ++counters.failedCheckpoints;
+            checkpointDue = sinceCheckpoint + options.checkpointInterval;
+        }
+    }
+    return true;
+}
+
+// Undoes the tree changes of `records`, newest first. The B-Tree keeps duplicates, so each
+// logged insert added exactly one copy of its key and each logged delete removed one.
+void DurableBTree::rollback(const vector<unsigned char>& records) {
+    for (size_t offset = records.size(); offset >= RECORD_SIZE; offset -= RECORD_SIZE) {
+        const unsigned char* record = records.data() + offset - RECORD_SIZE;
+        int key = static_cast<int>(getU32(record + 9));
+        if (record[8] == OP_INSERT) {
+            btree.deleteKey(key);
+        } else {
+            btree.insert(key);
+        }
+    }
+}
+
+bool DurableBTree::writeAndSync(const vector<unsigned char>& records) {
+    if (records.empty()) return true;
+    if (fwrite(records.data(), 1, records.size(), logFile) != records.size()) return false;
+    return syncFile(logFile);
+}
+
+// Waits out an in-flight flush, then checkpoints unless another thread already did while
+// we waited and fewer than `minRecords` records have been logged since.
+void DurableBTree::checkpointLocked(unique_lock<mutex>& lock, uint64_t minRecords) {
+    flushed.wait(lock, [this] { return !flushing; });
+    if (failed || sinceCheckpoint < minRecords) return;
+    writeCheckpoint();
+    flushed.notify_all();
+}
+
+// Writes the tree as a snapshot tagged with the current LSN to a temporary file, atomically
+// renames it over the previous checkpoint and starts an empty log. Records still pending
+// are covered by the checkpoint. If the new log cannot be created the old one stays in use:
+// recovery skips the records the checkpoint covers.
+void DurableBTree::writeCheckpoint() {
+    vector<int> keys;
+    btree.collectKeys(keys);
+
+    vector<unsigned char> image;
+    TreeSnapshot::encode(TreeSnapshot::BTREE, keys, nextLSN, image);
+
+    string tmpPath = checkpointPath + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        throw runtime_error("cannot create checkpoint: " + tmpPath);
+    }
+    bool ok = fwrite(image.data(), 1, image.size(), file) == image.size() && syncFile(file);
+    fclose(file);
+    if (!ok) {
+        throw runtime_error("checkpoint write failed: " + tmpPath);
+    }
+    filesystem::rename(tmpPath, checkpointPath);
+    syncDirectory(checkpointPath);
+
+    pending.clear();
+    durableLSN = nextLSN;
+    sinceCheckpoint = 0;
+    checkpointDue = options.checkpointInterval;
+    ++counters.checkpoints;
+
+    FILE* freshLog = fopen(logPath.c_str(), "wb");
+    if (freshLog == nullptr) {
+        if (logFile == nullptr) {
+            throw runtime_error("cannot open write-ahead log: " + logPath);
+        }
+        return;
+    }
+    if (logFile != nullptr) {
+        fclose(logFile);
+    }
+    logFile = freshLog;
+    syncFile(logFile);
+    syncDirectory(logPath);
+}
+
+void DurableBTree::recover() {
+    uint64_t checkpointLSN = 0;
+    vector<unsigned char> image;
+    if (TreeSnapshot::readFile(checkpointPath, image)) {
+        vector<int> keys;
+        if (!TreeSnapshot::decode(image, TreeSnapshot::BTREE, keys, checkpointLSN)) {
+            throw runtime_error("corrupt checkpoint: " + checkpointPath);
+        }
+        btree.buildFromSorted(keys);
+    }
+    nextLSN = checkpointLSN;
+
+    vector<unsigned char> log;
+    bool hasLog = TreeSnapshot::readFile(logPath, log) && !log.empty();
+    for (size_t offset = 0; offset + RECORD_SIZE <= log.size(); offset += RECORD_SIZE) {
+        const unsigned char* record = log.data() + offset;
+        if (Checksum::crc32(record, RECORD_SIZE - 4) != getU32(record + RECORD_SIZE - 4)) {
+            break;  // torn write at the tail: nothing after it was acknowledged
+        }
+        uint64_t lsn = getU64(record);
+        if (lsn <= checkpointLSN) {
+            continue;   // already in the checkpoint; the crash hit before the log was reset
+        }
+        int key = static_cast<int>(getU32(record + 9));
+        if (record[8] == OP_INSERT) {
+            btree.insert(key);
+        } else if (record[8] == OP_DELETE) {
+            btree.deleteKey(key);
+        }
+        nextLSN = lsn;
+        ++counters.replayedRecords;
+    }
+    durableLSN = nextLSN;
+
+    if (hasLog) {
+        writeCheckpoint();
+    } else {
+        logFile = fopen(logPath.c_str(), "ab");
+        if (logFile == nullptr) {
+            throw runtime_error("cannot open write-ahead log: " + logPath);
+        }
+    }
+}
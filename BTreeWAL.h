@@ -0,0 +1,81 @@
+
+#ifndef FINALPROJECTV2_BTREEWAL_H
+#define FINALPROJECTV2_BTREEWAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BTreeOperations.h"
+
+enum class WALSyncMode {
+    PerOperation,   // every insert/delete pays its own fsync
+    GroupCommit     // concurrent writers share one fsync per batch
+};
+
+struct WALOptions {
+    WALSyncMode syncMode = WALSyncMode::GroupCommit;
+    uint64_t checkpointInterval = 0;    // log records between automatic checkpoints, 0 = manual only
+};
+
+struct WALStats {
+    uint64_t syncs = 0;
+    uint64_t checkpoints = 0;
+    uint64_t failedCheckpoints = 0;     // automatic checkpoints that failed and will be retried
+    uint64_t replayedRecords = 0;
+};
+
+// A BTree whose inserts and deletes are durable once the call returns.
+// Files: <basePath>.wal (append-only log) and <basePath>.ckpt (last checkpoint).
+// The constructor restores the last checkpoint and replays the log records written after it.
+// If a log write fails, every insert and delete in the failed batch throws and the tree is left
+// as it was before them; every later insert, delete and checkpoint throws too. checkpoint()
+// throws if the checkpoint cannot be written, an automatic checkpoint only counts the failure.
+struct DurableBTree {
+    DurableBTree(int t, const std::string& basePath, WALOptions options = WALOptions());
+    ~DurableBTree();
+
+    DurableBTree(const DurableBTree&) = delete;
+    DurableBTree& operator=(const DurableBTree&) = delete;
+
+    void insert(int key);
+    bool deleteKey(int key);
+    bool contains(int key);
+    void checkpoint();
+    WALStats stats();
+
+    // Not synchronized; only use while no other thread is writing.
+    BTree& tree() { return btree; }
+
+private:
+    BTree btree;
+    WALOptions options;
+    std::string logPath;
+    std::string checkpointPath;
+    std::FILE* logFile;
+
+    std::mutex mtx;
+    std::condition_variable flushed;
+    std::vector<unsigned char> pending;
+    std::vector<unsigned char> writing;
+    bool flushing;
+    bool failed;
+    uint64_t nextLSN;
+    uint64_t durableLSN;
+    uint64_t sinceCheckpoint;
+    uint64_t checkpointDue;     // sinceCheckpoint value that triggers the next automatic checkpoint
+    WALStats counters;
+
+    void checkUsable();
+    uint64_t append(unsigned char op, int key);
+    bool commit(std::unique_lock<std::mutex>& lock, uint64_t lsn);
+    void rollback(const std::vector<unsigned char>& records);
+    bool writeAndSync(const std::vector<unsigned char>& records);
+    void checkpointLocked(std::unique_lock<std::mutex>& lock, uint64_t minRecords);
+    void writeCheckpoint();
+    void recover();
+};
+
+#endif //FINALPROJECTV2_BTREEWAL_H
@@ -0,0 +1,472 @@
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "BatchMode.h"
+#include "BSTOperations.h"
+#include "BTreeOperations.h"
+#include "OpLatency.h"
+#include "OpTrace.h"
+#include "RBTreeOperations.h"
+
+using namespace std;
+
+namespace BatchMode {
+    namespace {
+        enum class TreeKind { BST, RB, BTREE };
+
+        enum class Command {
+            Insert, Delete, Search, Min, Max, Successor, Predecessor, Kth, KthLargest,
+            Range, Inorder, Depth, Count, Save, Load, Tree, Unknown
+        };
+
+        struct CommandName {
+            const char* name;
+            Command command;
+        };
+
+        const CommandName COMMANDS[] = {
+                {"insert", Command::Insert}, {"delete", Command::Delete}, {"search", Command::Search},
+                {"min", Command::Min}, {"max", Command::Max}, {"successor", Command::Successor},
+                {"predecessor", Command::Predecessor}, {"kth", Command::Kth}, {"kthlargest", Command::KthLargest},
+                {"range", Command::Range}, {"inorder", Command::Inorder}, {"depth", Command::Depth},
+                {"count", Command::Count}, {"save", Command::Save}, {"load", Command::Load}, {"tree", Command::Tree},
+        };
+
+        // The trace opcode of each Command, up to Count.
+        const OpTrace::Op TRACE_OPS[] = {
+                OpTrace::INSERT, OpTrace::DELETE, OpTrace::SEARCH, OpTrace::MIN, OpTrace::MAX,
+                OpTrace::SUCCESSOR, OpTrace::PREDECESSOR, OpTrace::KTH, OpTrace::KTH_LARGEST,
+                OpTrace::RANGE, OpTrace::INORDER, OpTrace::DEPTH, OpTrace::COUNT,
+        };
+
+        const size_t READ_CHUNK = 1 << 16;
+        const size_t OUTPUT_FLUSH_SIZE = 1 << 16;
+
+        Command parseCommand(string_view word) {
+            for (const CommandName& entry : COMMANDS) {
+                if (word == entry.name) return entry.command;
+            }
+            return Command::Unknown;
+        }
+
+        bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        string_view nextWord(const char*& p, const char* end) {
+            while (p < end && isSpace(*p)) ++p;
+            const char* start = p;
+            while (p < end && !isSpace(*p)) ++p;
+            return string_view(start, p - start);
+        }
+
+        string_view trim(const char* p, const char* end) {
+            while (p < end && isSpace(*p)) ++p;
+            while (end > p && isSpace(end[-1])) --end;
+            return string_view(p, end - p);
+        }
+
+        struct Session {
+            TreeKind kind = TreeKind::BST;
+            bool quiet = false;
+            unique_ptr<BSTree> bst;
+            unique_ptr<RBTree> rb;
+            unique_ptr<BTree> bt;
+
+            // Reused across lines so steady-state parsing does not allocate.
+            vector<int> args;
+            vector<int> keys;
+            string out;
+            long lineNumber = 0;
+            int errors = 0;
+
+            // Replaces the current tree with an empty one; an invalid name or degree leaves the
+            // current tree in place.
+            bool selectTree(string_view name, int degree) {
+                bool isRB = name == "rb" || name == "rbtree";
+                bool isBTree = name == "btree";
+                if (name != "bst" && !isRB && !isBTree) return false;
+                if (isBTree && degree < 2) return false;
+                bst.reset();
+                rb.reset();
+                bt.reset();
+                if (name == "bst") {
+                    kind = TreeKind::BST;
+                    bst.reset(new BSTree());
+                    OpTrace::record(OpTrace::TREE, OpTrace::BST);
+                } else if (isRB) {
+                    kind = TreeKind::RB;
+                    rb.reset(new RBTree());
+                    OpTrace::record(OpTrace::TREE, OpTrace::RED_BLACK);
+                } else {
+                    kind = TreeKind::BTREE;
+                    bt.reset(new BTree(degree));
+                    OpTrace::record(OpTrace::TREE, OpTrace::BTREE, degree);
+                }
+                return true;
+            }
+
+            void error(string_view message) {
+                ++errors;
+                flush();
+                fprintf(stderr, "line %ld: %.*s\n", lineNumber, static_cast<int>(message.size()), message.data());
+            }
+
+            void unsupported(string_view command) {
+                string message(command);
+                message += kind == TreeKind::RB ? " is not supported by the red-black tree"
+                                                : " is not supported by the B-Tree";
+                error(message);
+            }
+
+            void writeInt(int value) {
+                char digits[16];
+                auto result = to_chars(digits, digits + sizeof(digits), value);
+                out.append(digits, result.ptr);
+            }
+
+            void writeSeparator() {
+                if (!out.empty() && out.back() != '\n') out.push_back(' ');
+            }
+
+            void endLine() {
+                out.push_back('\n');
+                if (out.size() >= OUTPUT_FLUSH_SIZE) flush();
+            }
+
+            void flush() {
+                fwrite(out.data(), 1, out.size(), stdout);
+                out.clear();
+            }
+
+            bool parseArgs(const char* p, const char* end) {
+                args.clear();
+                while (true) {
+                    while (p < end && isSpace(*p)) ++p;
+                    if (p == end) return true;
+                    int value;
+                    auto result = from_chars(p, end, value);
+                    if (result.ec != errc() || (result.ptr < end && !isSpace(*result.ptr))) {
+                        return false;
+                    }
+                    args.push_back(value);
+                    p = result.ptr;
+                }
+            }
+
+            void processLine(const char* p, const char* end) {
+                ++lineNumber;
+                string_view word = nextWord(p, end);
+                if (word.empty() || word[0] == '#') return;
+
+                Command command = parseCommand(word);
+                if (command == Command::Unknown) {
+                    error("unknown command '" + string(word) + "'");
+                    return;
+                }
+                if (command == Command::Save || command == Command::Load) {
+                    string path(trim(p, end));
+                    if (path.empty()) {
+                        error(string(word) + " expects a file path");
+                    } else if (!(command == Command::Save ? save(path) : load(path))) {
+                        error("cannot " + string(word) + " '" + path + "'");
+                    }
+                    return;
+                }
+                if (command == Command::Tree) {
+                    string_view name = nextWord(p, end);
+                    if (!parseArgs(p, end) || args.size() > 1 || !selectTree(name, args.empty() ? 3 : args[0])) {
+                        error("expected: tree bst|rb|btree [t >= 2]");
+                    }
+                    return;
+                }
+                if (!parseArgs(p, end)) {
+                    error("invalid number in '" + string(word) + "'");
+                    return;
+                }
+                execute(command, word);
+            }
+
+            void execute(Command command, string_view word) {
+                switch (command) {
+                    case Command::Insert:
+                    case Command::Delete:
+                        if (args.empty()) {
+                            error(string(word) + " expects at least one key");
+                            return;
+                        }
+                        for (int key : args) {
+                            if (command == Command::Insert) insert(key); else remove(key);
+                        }
+                        return;
+                    case Command::Search:
+                    case Command::Successor:
+                    case Command::Predecessor:
+                    case Command::Kth:
+                    case Command::KthLargest:
+                        if (args.empty()) {
+                            error(string(word) + " expects at least one argument");
+                            return;
+                        }
+                        if (kind == TreeKind::BTREE && (command == Command::Successor || command == Command::Predecessor)) {
+                            unsupported(word);
+                            return;
+                        }
+                        if (kind == TreeKind::RB && (command == Command::Kth || command == Command::KthLargest)) {
+                            unsupported(word);
+                            return;
+                        }
+                        for (int arg : args) {
+                            query(command, arg);
+                        }
+                        break;
+                    case Command::Range:
+                        if (args.size() != 2) {
+                            error("range expects: range low high");
+                            return;
+                        }
+                        if (kind != TreeKind::BST) {
+                            unsupported(word);
+                            return;
+                        }
+                        OpTrace::record(OpTrace::RANGE, args[0], args[1]);
+                        for (int key : bst->rangeQuery(args[0], args[1])) {
+                            writeSeparator();
+                            writeInt(key);
+                        }
+                        break;
+                    case Command::Min:
+                    case Command::Max:
+                    case Command::Inorder:
+                    case Command::Depth:
+                    case Command::Count:
+                        if (!args.empty()) {
+                            error(string(word) + " takes no arguments");
+                            return;
+                        }
+                        summary(command);
+                        break;
+                    default:
+                        return;
+                }
+                if (quiet) {
+                    out.clear();
+                } else {
+                    endLine();
+                }
+            }
+
+            void insert(int key) {
+                OpTrace::record(OpTrace::INSERT, key);
+                switch (kind) {
+                    case TreeKind::BST: bst->insert(bst->createNode(key)); break;
+                    case TreeKind::RB: rb->RBInsert(key); break;
+                    case TreeKind::BTREE: bt->insert(key); break;
+                }
+            }
+
+            void remove(int key) {
+                OpTrace::record(OpTrace::DELETE, key);
+                switch (kind) {
+                    case TreeKind::BST: {
+                        Node* node = bst->search(bst->root, key);
+                        if (node) bst->del(node);
+                        break;
+                    }
+                    case TreeKind::RB:
+                        rb->erase(key);
+                        break;
+                    case TreeKind::BTREE:
+                        bt->deleteKey(key);
+                        break;
+                }
+            }
+
+            void writeNode(bool found, int key, const char* missing) {
+                writeSeparator();
+                if (found) writeInt(key); else out.append(missing);
+            }
+
+            void query(Command command, int arg) {
+                OpTrace::record(TRACE_OPS[static_cast<int>(command)], arg);
+                if (command == Command::Search) {
+                    bool found;
+                    switch (kind) {
+                        case TreeKind::BST: found = bst->search(bst->root, arg) != nullptr; break;
+                        case TreeKind::RB: found = rb->search(rb->root, arg) != NIL; break;
+                        default: found = bt->search(arg) != nullptr; break;
+                    }
+                    writeSeparator();
+                    out.push_back(found ? '1' : '0');
+                    return;
+                }
+                if (kind == TreeKind::BTREE) {
+                    size_t size = bt->size();
+                    const int* result = nullptr;
+                    if (arg >= 1 && static_cast<size_t>(arg) <= size) {
+                        result = bt->select(command == Command::Kth ? arg - 1 : size - arg);
+                    }
+                    writeNode(result != nullptr, result ? *result : 0, "none");
+                } else if (kind == TreeKind::BST) {
+                    if (command == Command::Kth) {
+                        Node* result = bst->kthSmallest(arg);
+                        writeNode(result != nullptr, result ? result->key : 0, "none");
+                    } else if (command == Command::KthLargest) {
+                        Node* result = bst->kthLargest(arg);
+                        writeNode(result != nullptr, result ? result->key : 0, "none");
+                    } else {
+                        Node* node = bst->search(bst->root, arg);
+                        if (node == nullptr) {
+                            writeNode(false, 0, "missing");
+                            return;
+                        }
+                        Node* next = command == Command::Successor ? bst->successor(node) : bst->predecessor(node);
+                        writeNode(next != nullptr, next ? next->key : 0, "none");
+                    }
+                } else {
+                    RBNode* node = rb->search(rb->root, arg);
+                    if (node == NIL) {
+                        writeNode(false, 0, "missing");
+                        return;
+                    }
+                    RBNode* next = command == Command::Successor ? rb->successor(node) : rb->predecessor(node);
+                    writeNode(next != NIL, next->key, "none");
+                }
+            }
+
+            void summary(Command command) {
+                OpTrace::record(TRACE_OPS[static_cast<int>(command)]);
+                bool empty = kind == TreeKind::BST ? bst->root == nullptr
+                           : kind == TreeKind::RB ? rb->root == NIL
+                           : bt->root == nullptr;
+                switch (command) {
+                    case Command::Min:
+                    case Command::Max:
+                        if (empty) {
+                            out.append("empty");
+                        } else if (kind == TreeKind::BST) {
+                            writeInt((command == Command::Min ? bst->minimum() : bst->maximum())->key);
+                        } else if (kind == TreeKind::RB) {
+                            writeInt((command == Command::Min ? rb->minimum() : rb->maximum())->key);
+                        } else {
+                            writeInt(*(command == Command::Min ? bt->findMinimumKey() : bt->findMaximumKey()));
+                        }
+                        break;
+                    case Command::Depth:
+                        writeInt(kind == TreeKind::BST ? bst->depth() : kind == TreeKind::RB ? rb->depth() : bt->depth());
+                        break;
+                    case Command::Count:
+                        if (kind == TreeKind::BTREE) {
+                            writeInt(static_cast<int>(bt->size()));
+                            break;
+                        }
+                        [[fallthrough]];
+                    case Command::Inorder:
+                        keys.clear();
+                        switch (kind) {
+                            case TreeKind::BST: bst->collectKeys(bst->root, keys); break;
+                            case TreeKind::RB: rb->collectKeys(rb->root, keys); break;
+                            case TreeKind::BTREE: bt->collectKeys(keys); break;
+                        }
+                        if (command == Command::Count) {
+                            writeInt(static_cast<int>(keys.size()));
+                        } else {
+                            for (int key : keys) {
+                                writeSeparator();
+                                writeInt(key);
+                            }
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            bool save(const string& path) {
+                switch (kind) {
+                    case TreeKind::BST: return bst->save(path);
+                    case TreeKind::RB: return rb->save(path);
+                    default: return bt->save(path);
+                }
+            }
+
+            bool load(const string& path) {
+                switch (kind) {
+                    case TreeKind::BST: return bst->load(path);
+                    case TreeKind::RB: return rb->load(path);
+                    default: return bt->load(path);
+                }
+            }
+        };
+    }
+
+    int run(const Options& options) {
+        if (!options.tracePath.empty() && !OpTrace::start(options.tracePath)) {
+            fprintf(stderr, "cannot create trace '%s'\n", options.tracePath.c_str());
+            return 1;
+        }
+        Session session;
+        session.quiet = options.quiet;
+        if (!session.selectTree(options.tree, options.degree)) {
+            fprintf(stderr, "unknown tree '%s' (expected bst, rb or btree with t >= 2)\n", options.tree.c_str());
+            OpTrace::stop();
+            return 1;
+        }
+
+        FILE* in = options.scriptPath == "-" ? stdin : fopen(options.scriptPath.c_str(), "rb");
+        if (in == nullptr) {
+            fprintf(stderr, "cannot open script '%s'\n", options.scriptPath.c_str());
+            OpTrace::stop();
+            return 1;
+        }
+        if (options.latency) {
+            OpLatency::setEnabled(true);
+        }
+
+        // Read fixed-size chunks and hand complete lines to the session; a partial last line
+        // is moved to the front of the buffer and completed by the next read.
+        vector<char> buffer(READ_CHUNK);
+        size_t filled = 0;
+        while (true) {
+            if (filled == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            }
+            size_t n = fread(buffer.data() + filled, 1, buffer.size() - filled, in);
+            filled += n;
+
+            const char* data = buffer.data();
+            size_t start = 0;
+            while (const void* newline = memchr(data + start, '\n', filled - start)) {
+                const char* lineEnd = static_cast<const char*>(newline);
+                session.processLine(data + start, lineEnd);
+                start = lineEnd - data + 1;
+            }
+            if (n == 0) {
+                if (start < filled) {
+                    session.processLine(data + start, data + filled);
+                }
+                break;
+            }
+            memmove(buffer.data(), data + start, filled - start);
+            filled -= start;
+        }
+
+        if (in != stdin) {
+            fclose(in);
+        }
+        session.flush();
+        fflush(stdout);
+        if (options.latency) {
+            OpLatency::report(cerr);
+        }
+        if (!OpTrace::stop()) {
+            fprintf(stderr, "cannot write trace '%s'\n", options.tracePath.c_str());
+            return 1;
+        }
+        return session.errors == 0 ? 0 : 1;
+    }
+}
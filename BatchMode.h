@@ -0,0 +1,33 @@
+
+#ifndef FINALPROJECTV2_BATCHMODE_H
+#define FINALPROJECTV2_BATCHMODE_H
+
+#include <string>
+
+// Non-interactive driver: runs a command script against one tree, one command per line.
+//
+//   tree bst|rb|btree [t]      switch to a new, empty tree (B-Tree minimum degree t, default 3)
+//   insert k...  delete k...   mutations, no output
+//   search k...                1 or 0 per key
+//   min  max  depth  count  inorder
+//   successor k...  predecessor k...  kth k...  kthlargest k...
+//   range low high
+//   save path  load path
+//
+// Blank lines and lines starting with '#' are ignored. Query results are written one line per
+// command to stdout; errors go to stderr with their line number and do not stop the script.
+namespace BatchMode {
+    struct Options {
+        std::string scriptPath = "-";   // "-" reads the script from stdin
+        std::string tree = "bst";
+        int degree = 3;
+        bool quiet = false;             // suppress query output, report errors only
+        bool latency = false;           // time each tree operation, print percentiles to stderr at the end
+        std::string tracePath;          // record the tree operations to this trace (OpTrace.h) when set
+    };
+
+    // Returns the process exit status: 0 if every command succeeded, 1 otherwise.
+    int run(const Options& options);
+}
+
+#endif //FINALPROJECTV2_BATCHMODE_H
@@ -0,0 +1,13 @@
+
+#ifndef FINALPROJECTV2_CHECKSUM_H
+#define FINALPROJECTV2_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Checksum {
+    // CRC-32 (IEEE 802.3). Pass the previous result as `crc` to checksum data in pieces.
+    uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+}
+
+#endif //FINALPROJECTV2_CHECKSUM_H
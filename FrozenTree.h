@@ -0,0 +1,90 @@
+
+#ifndef FINALPROJECTV2_FROZENTREE_H
+#define FINALPROJECTV2_FROZENTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Read-only copy of a tree's keys in Eytzinger (BFS) order: the root at index 1 and the children
+// of k at 2k and 2k + 1, so the first levels of every search share the same few cache lines and
+// the next levels are contiguous. A search is a fixed loop without data-dependent branches: each
+// step adds the comparison result to the index. It also prefetches the cache line that holds the
+// node's descendants four levels down (for 4-byte keys), so the loads of later levels overlap
+// the current ones.
+//
+// Built by BasicBSTree::freeze() / BasicRBTree::freeze(); later changes to the tree do not show.
+// The lookups take anything Compare can order against Key.
+template <typename Key, typename Compare = std::less<Key>>
+class FrozenTree {
+public:
+    explicit FrozenTree(const std::vector<Key>& sortedKeys) : count(sortedKeys.size()) {
+        // One spare line lets index 0 start on a cache-line boundary where the key size allows.
+        storage.resize(count + 1 + KEYS_PER_LINE);
+        offset = 0;
+        while (offset < KEYS_PER_LINE && reinterpret_cast<uintptr_t>(storage.data() + offset) % CACHE_LINE != 0) {
+            offset++;
+        }
+        if (offset == KEYS_PER_LINE) offset = 0;
+        ranks.resize(count + 1);
+        fill(sortedKeys, 0, 1);
+    }
+
+    size_t size() const { return count; }
+
+    // The smallest key not ordered before `key`, or nullptr when every key is.
+    template <typename K>
+    const Key* lowerBound(const K& key) const {
+        size_t k = descend(key);
+        return k == 0 ? nullptr : &keys()[k];
+    }
+
+    template <typename K>
+    bool contains(const K& key) const {
+        size_t k = descend(key);
+        return k != 0 && !Compare()(key, keys()[k]);
+    }
+
+    // Number of keys ordered before `key`.
+    template <typename K>
+    size_t rank(const K& key) const {
+        size_t k = descend(key);
+        return k == 0 ? count : ranks[k];
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t KEYS_PER_LINE = sizeof(Key) >= CACHE_LINE ? 1 : CACHE_LINE / sizeof(Key);
+
+    std::vector<Key> storage;
+    size_t offset;
+    size_t count;
+    std::vector<uint32_t> ranks;    // in-order position of each Eytzinger slot
+
+    const Key* keys() const { return storage.data() + offset; }
+
+    size_t fill(const std::vector<Key>& sortedKeys, size_t next, size_t k) {
+        if (k > count) return next;
+        next = fill(sortedKeys, next, 2 * k);
+        storage[offset + k] = sortedKeys[next];
+        ranks[k] = static_cast<uint32_t>(next++);
+        return fill(sortedKeys, next, 2 * k + 1);
+    }
+
+    // Eytzinger index of the lower bound, 0 if there is none. The loop goes right whenever the
+    // node is below `key`; the lower bound is the last node where it went left, which is found by
+    // dropping the trailing right turns (the trailing 1 bits of k) and the final left turn.
+    template <typename K>
+    size_t descend(const K& key) const {
+        const Key* data = keys();
+        size_t k = 1;
+        while (k <= count) {
+            __builtin_prefetch(data + KEYS_PER_LINE * k);
+            k = 2 * k + static_cast<size_t>(Compare()(data[k], key));
+        }
+        return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+    }
+};
+
+#endif //FINALPROJECTV2_FROZENTREE_H
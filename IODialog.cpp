@@ -1,6 +1,126 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <thread>
 #include "IODialog.h"
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace IODialog {
+    namespace {
+        // Read-only view of a whole file; empty files map to a null pointer with size 0.
+        class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+                file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+                if (file == INVALID_HANDLE_VALUE) return;
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(file, &fileSize)) return;
+                length = static_cast<size_t>(fileSize.QuadPart);
+                if (length > 0) {
+                    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (mapping == nullptr) return;
+                    bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    if (bytes == nullptr) return;
+                }
+#else
+                fd = open(path.c_str(), O_RDONLY);
+                if (fd < 0) return;
+                struct stat info;
+                if (fstat(fd, &info) != 0) return;
+                length = static_cast<size_t>(info.st_size);
+                if (length > 0) {
+                    void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (view == MAP_FAILED) return;
+                    madvise(view, length, MADV_SEQUENTIAL);
+                    bytes = static_cast<const char*>(view);
+                }
+#endif
+                ok = true;
+            }
+
+            ~MappedFile() {
+#ifdef _WIN32
+                if (bytes != nullptr) UnmapViewOfFile(bytes);
+                if (mapping != nullptr) CloseHandle(mapping);
+                if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+                if (bytes != nullptr) munmap(const_cast<char*>(bytes), length);
+                if (fd >= 0) close(fd);
+#endif
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool valid() const { return ok; }
+            const char* data() const { return bytes; }
+            size_t size() const { return length; }
+
+        private:
+#ifdef _WIN32
+            HANDLE file = INVALID_HANDLE_VALUE;
+            HANDLE mapping = nullptr;
+#else
+            int fd = -1;
+#endif
+            const char* bytes = nullptr;
+            size_t length = 0;
+            bool ok = false;
+        };
+
+        // Below this size a single thread is faster than starting workers.
+        const size_t MIN_BYTES_PER_THREAD = 1 << 20;
+
+        bool isKeySeparator(char c) {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        bool parseTextChunk(const char* p, const char* end, std::vector<int>& out) {
+            out.reserve((end - p) / 4);
+            while (true) {
+                while (p < end && isKeySeparator(*p)) ++p;
+                if (p == end) return true;
+                int key;
+                auto result = std::from_chars(p, end, key);
+                if (result.ec != std::errc() || (result.ptr < end && !isKeySeparator(*result.ptr))) {
+                    return false;
+                }
+                out.push_back(key);
+                p = result.ptr;
+            }
+        }
+
+        void copyBinaryChunk(const char* p, size_t count, int* out) {
+            for (size_t i = 0; i < count; ++i, p += 4) {
+                const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+                out[i] = static_cast<int>(b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<uint32_t>(b[3]) << 24));
+            }
+        }
+
+        template <typename Work>
+        void runWorkers(unsigned workers, Work work) {
+            std::vector<std::thread> pool;
+            for (unsigned i = 1; i < workers; ++i) {
+                pool.emplace_back(work, i);
+            }
+            work(0);
+            for (std::thread& thread : pool) {
+                thread.join();
+            }
+        }
+    }
+
     void getNodeKeys(std::list<int>& nodeKeys) {
         std::cout << "Enter node keys (space-separated): ";
         int key;
@@ -39,4 +159,78 @@ namespace IODialog {
         std::cin >> high;
         return {low, high};
     }
+
+    std::string getFilePath() {
+        std::cout << "Enter the file path: ";
+        std::string path;
+        std::cin >> path;
+        return path;
+    }
+
+    bool getKeysFromFile(std::vector<int>& keys) {
+        std::string path = getFilePath();
+        if (!readKeyFile(path, keyFileFormatFor(path), keys)) {
+            std::cout << "Could not read keys from " << path << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    KeyFileFormat keyFileFormatFor(const std::string& path) {
+        size_t dot = path.rfind('.');
+        return (dot != std::string::npos && path.compare(dot, std::string::npos, ".bin") == 0)
+               ? KeyFileFormat::Binary : KeyFileFormat::Text;
+    }
+
+    bool readKeyFile(const std::string& path, KeyFileFormat format, std::vector<int>& keys, unsigned threads) {
+        MappedFile file(path);
+        if (!file.valid()) return false;
+        const char* data = file.data();
+        size_t size = file.size();
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(threads, size / MIN_BYTES_PER_THREAD + 1));
+        size_t base = keys.size();
+
+        if (format == KeyFileFormat::Binary) {
+            if (size % 4 != 0) return false;
+            size_t count = size / 4;
+            keys.resize(base + count);
+            int* out = keys.data() + base;
+            runWorkers(workers, [&](unsigned i) {
+                size_t first = count * i / workers;
+                size_t last = count * (i + 1) / workers;
+                copyBinaryChunk(data + first * 4, last - first, out + first);
+            });
+            return true;
+        }
+
+        // Move each cut forward to the next separator so no key straddles two chunks.
+        std::vector<size_t> cuts(workers + 1, size);
+        cuts[0] = 0;
+        for (unsigned i = 1; i < workers; ++i) {
+            size_t cut = std::max(cuts[i - 1], size / workers * i);
+            while (cut < size && !isKeySeparator(data[cut])) ++cut;
+            cuts[i] = cut;
+        }
+
+        std::vector<std::vector<int>> parts(workers);
+        std::vector<char> parsed(workers, 0);
+        runWorkers(workers, [&](unsigned i) {
+            parsed[i] = parseTextChunk(data + cuts[i], data + cuts[i + 1], parts[i]);
+        });
+        if (std::find(parsed.begin(), parsed.end(), 0) != parsed.end()) return false;
+
+        std::vector<size_t> offsets(workers + 1, base);
+        for (unsigned i = 0; i < workers; ++i) {
+            offsets[i + 1] = offsets[i] + parts[i].size();
+        }
+        keys.resize(offsets[workers]);
+        runWorkers(workers, [&](unsigned i) {
+            std::copy(parts[i].begin(), parts[i].end(), keys.begin() + offsets[i]);
+        });
+        return true;
+    }
 }
@@ -6,12 +6,26 @@
 #include <list>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace IODialog {
+    enum class KeyFileFormat {
+        Text,   // integers separated by any whitespace
+        Binary  // raw little-endian 32-bit integers
+    };
+
     void getNodeKeys(std::list<int>& nodeKeys);
     int getNodeKey();
     std::list<int> getMultipleKeys(int count);
     std::pair<int, int> getRange();
+    std::string getFilePath();
+    bool getKeysFromFile(std::vector<int>& keys);
+
+    // Memory-maps `path` and parses it on `threads` workers (0 = one per hardware thread),
+    // each taking a chunk that starts and ends on whitespace. Keys are appended to `keys` in
+    // file order. Returns false if the file cannot be opened or contains a malformed key.
+    bool readKeyFile(const std::string& path, KeyFileFormat format, std::vector<int>& keys, unsigned threads = 0);
+    KeyFileFormat keyFileFormatFor(const std::string& path);
 }
 
 
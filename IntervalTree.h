@@ -0,0 +1,139 @@
+
+#ifndef FINALPROJECTV2_INTERVALTREE_H
+#define FINALPROJECTV2_INTERVALTREE_H
+
+#include <functional>
+#include <utility>
+#include <vector>
+#include "RBTreeOperations.h"
+
+// Closed interval [low, high]; low must not order after high.
+template <typename Point>
+struct Interval {
+    Point low;
+    Point high;
+};
+
+// What an interval tree node stores next to its key, the interval's low end.
+template <typename Point, typename Value>
+struct IntervalEntry {
+    Point high;
+    Point maxHigh;      // the largest high end in the node's subtree
+    Value value;
+};
+
+// BasicRBTree augmentation (TreeTraits.h) that keeps IntervalEntry::maxHigh.
+template <typename Compare>
+struct MaxHighEnd {
+    template <typename Node>
+    void operator()(Node* x, Node* nil) const {
+        x->value.maxHigh = x->value.high;
+        if (x->left != nil && Compare()(x->value.maxHigh, x->left->value.maxHigh))
+            x->value.maxHigh = x->left->value.maxHigh;
+        if (x->right != nil && Compare()(x->value.maxHigh, x->right->value.maxHigh))
+            x->value.maxHigh = x->right->value.maxHigh;
+    }
+};
+
+// Interval tree (CLRS 14.3): a BasicRBTree keyed by the intervals' low ends whose nodes also keep
+// the largest high end in their subtree. The tree updates that maximum on the insert and delete
+// paths and in every rotation, so both fixups keep it too. A query skips any subtree whose
+// maximum lies below the query's low end, and everything right of a node whose low end lies
+// above the query's high end.
+//
+// anyOverlapping() is O(log n). Reporting k overlaps is O(min(n, (k + 1) log n)) in the worst
+// case; on intervals much shorter than the key range it is close to O(log n + k), since the
+// pruned walk then stays near the k results. The same interval may be stored more than once.
+template <typename Point, typename Value = NoValue, typename Compare = std::less<Point>>
+struct BasicIntervalTree {
+    using Entry = IntervalEntry<Point, Value>;
+    using Tree = BasicRBTree<Point, Entry, Compare, MaxHighEnd<Compare>>;
+    using Node = typename Tree::Node;
+
+    static inline Node* const NIL = Tree::NIL;
+
+    Tree tree;
+
+    Node* insert(const Interval<Point>& interval, Value value = Value()) {
+        return tree.RBInsert(interval.low, Entry{interval.high, interval.high, std::move(value)});
+    }
+
+    // Removes one copy of `interval`; false if it is not stored.
+    bool erase(const Interval<Point>& interval) {
+        Node* x = find(interval);
+        if (x == NIL) return false;
+        tree.RBDelete(x);
+        return true;
+    }
+
+    // A node holding exactly `interval`, or NIL.
+    Node* find(const Interval<Point>& interval) {
+        Node* x = firstNotBelow(interval.low);
+        for (; x != NIL && !before(interval.low, x->key); x = tree.successor(x)) {
+            if (!before(x->value.high, interval.high) && !before(interval.high, x->value.high)) return x;
+        }
+        return NIL;
+    }
+
+    // Appends every node whose interval overlaps q to `out`, by low end, and returns how many.
+    size_t overlapping(const Interval<Point>& q, std::vector<Node*>& out) {
+        TREE_STAT(Tree::stats.searches++);
+        size_t start = out.size();
+        collectOverlapping(tree.root, q, out);
+        return out.size() - start;
+    }
+
+    // The intervals containing `point`.
+    size_t stab(const Point& point, std::vector<Node*>& out) { return overlapping({point, point}, out); }
+
+    // Some node whose interval overlaps q, or NIL. Going left is safe whenever the left subtree
+    // reaches q.low: if nothing there overlaps, nothing to the right can either.
+    Node* anyOverlapping(const Interval<Point>& q) {
+        TREE_STAT(Tree::stats.searches++);
+        Node* x = tree.root;
+        while (x != NIL && !overlaps(x, q)) {
+            TREE_STAT(Tree::stats.nodesVisited++);
+            x = x->left != NIL && !before(x->left->value.maxHigh, q.low) ? x->left : x->right;
+        }
+        return x;
+    }
+
+    size_t size() const { return tree.size(); }
+
+private:
+    template <typename A, typename B>
+    static bool before(const A& a, const B& b) { return Compare()(a, b); }
+
+    static bool overlaps(Node* x, const Interval<Point>& q) {
+        return !before(q.high, x->key) && !before(x->value.high, q.low);
+    }
+
+    // The leftmost node whose low end is not below `low`, or NIL.
+    Node* firstNotBelow(const Point& low) {
+        Node* first = NIL;
+        for (Node* x = tree.root; x != NIL;) {
+            if (before(x->key, low)) {
+                x = x->right;
+            } else {
+                first = x;
+                x = x->left;
+            }
+        }
+        return first;
+    }
+
+    // In-order walk over the subtrees that can hold overlaps; the right child is a loop, not a call.
+    void collectOverlapping(Node* x, const Interval<Point>& q, std::vector<Node*>& out) {
+        while (x != NIL && !before(x->value.maxHigh, q.low)) {
+            TREE_STAT(Tree::stats.nodesVisited++);
+            collectOverlapping(x->left, q, out);
+            if (before(q.high, x->key)) return;
+            if (!before(x->value.high, q.low)) out.push_back(x);
+            x = x->right;
+        }
+    }
+};
+
+using IntervalTree = BasicIntervalTree<int>;
+
+#endif //FINALPROJECTV2_INTERVALTREE_H
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "OpLatency.h"
+
+using namespace std;
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) {
+        uint64_t n = other.counts[i].load(memory_order_relaxed);
+        if (n != 0) counts[i].fetch_add(n, memory_order_relaxed);
+    }
+    uint64_t otherMax = other.max();
+    if (otherMax > max()) maxValue.store(otherMax, memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (atomic<uint64_t>& bucket : counts) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    maxValue.store(0, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t total = 0;
+    for (const atomic<uint64_t>& bucket : counts) {
+        total += bucket.load(memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::valueAtQuantile(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * total);
+    if (rank >= total) rank = total - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i].load(memory_order_relaxed);
+        if (seen > rank) return std::min(bucketUpperValue(i), max());
+    }
+    return max();
+}
+
+namespace OpLatency {
+    atomic<bool> timingEnabled(false);
+    atomic<uint32_t> sampleInterval(DEFAULT_SAMPLE_INTERVAL);
+
+    namespace {
+        const char* const NAMES[OP_COUNT] = {
+                "bst.insert", "bst.search", "bst.delete", "bst.range", "bst.kth",
+                "rb.insert", "rb.search", "rb.delete",
+                "btree.insert", "btree.search", "btree.delete"
+        };
+
+        struct ThreadHistograms {
+            LatencyHistogram ops[OP_COUNT];
+        };
+
+        // Histograms of running threads, plus the merged histograms of threads that have exited.
+        mutex registryMutex;
+        vector<ThreadHistograms*> liveThreads;
+        ThreadHistograms retired;
+        double nsPerTick = 1.0;
+        once_flag calibrated;
+
+        // Owns the calling thread's histograms; registered on first use, folded into `retired`
+        // when the thread exits.
+        struct ThreadSlot {
+            unique_ptr<ThreadHistograms> histograms;
+
+            ThreadHistograms& get() {
+                if (!histograms) {
+                    histograms.reset(new ThreadHistograms());
+                    lock_guard<mutex> lock(registryMutex);
+                    liveThreads.push_back(histograms.get());
+                }
+                return *histograms;
+            }
+
+            ~ThreadSlot() {
+                if (!histograms) return;
+                lock_guard<mutex> lock(registryMutex);
+                for (int op = 0; op < OP_COUNT; ++op) {
+                    retired.ops[op].merge(histograms->ops[op]);
+                }
+                liveThreads.erase(find(liveThreads.begin(), liveThreads.end(), histograms.get()));
+            }
+        };
+
+        thread_local ThreadSlot slot;
+
+        void calibrate() {
+#if OP_LATENCY_TSC
+            auto wallStart = chrono::steady_clock::now();
+            uint64_t tickStart = now();
+            this_thread::sleep_for(chrono::milliseconds(20));
+            uint64_t ticks = now() - tickStart;
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - wallStart).count();
+            if (ticks > 0) nsPerTick = ns / ticks;
+#endif
+        }
+
+        void merged(Op op, LatencyHistogram& out) {
+            lock_guard<mutex> lock(registryMutex);
+            out.merge(retired.ops[op]);
+            for (ThreadHistograms* thread : liveThreads) {
+                out.merge(thread->ops[op]);
+            }
+        }
+    }
+
+    void setEnabled(bool enabled, uint32_t sampleEvery) {
+        if (enabled) call_once(calibrated, calibrate);
+        sampleInterval.store(sampleEvery == 0 ? 1 : sampleEvery, memory_order_relaxed);
+        timingEnabled.store(enabled, memory_order_relaxed);
+    }
+
+    const char* name(Op op) {
+        return op < OP_COUNT ? NAMES[op] : "unknown";
+    }
+
+    void record(Op op, uint64_t ticks) {
+        slot.get().ops[op].record(ticks);
+    }
+
+    Summary summarize(Op op) {
+        unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+        merged(op, *histogram);
+        Summary summary;
+        summary.count = histogram->count();
+        summary.p50Ns = histogram->valueAtQuantile(0.50) * nsPerTick;
+        summary.p99Ns = histogram->valueAtQuantile(0.99) * nsPerTick;
+        summary.p999Ns = histogram->valueAtQuantile(0.999) * nsPerTick;
+        summary.maxNs = histogram->max() * nsPerTick;
+        return summary;
+    }
+
+    void report(ostream& out) {
+        bool any = false;
+        ios::fmtflags flags = out.flags();
+        out << fixed << setprecision(0);
+        for (int op = 0; op < OP_COUNT; ++op) {
+            Summary summary = summarize(static_cast<Op>(op));
+            if (summary.count == 0) continue;
+            if (!any) {
+                out << left << setw(14) << "operation" << right << setw(12) << "samples" << setw(10) << "p50_ns"
+                    << setw(10) << "p99_ns" << setw(10) << "p999_ns" << setw(12) << "max_ns" << "\n";
+                any = true;
+            }
+            out << left << setw(14) << NAMES[op] << right << setw(12) << summary.count << setw(10) << summary.p50Ns
+                << setw(10) << summary.p99Ns << setw(10) << summary.p999Ns << setw(12) << summary.maxNs << "\n";
+        }
+        if (!any) {
+            out << (enabled() ? "No operations timed yet.\n" : "Latency timing is off.\n");
+        }
+        out.flags(flags);
+    }
+
+    void reset() {
+        lock_guard<mutex> lock(registryMutex);
+        for (int op = 0; op < OP_COUNT; ++op) {
+            retired.ops[op].reset();
+            for (ThreadHistograms* thread : liveThreads) {
+                thread->ops[op].reset();
+            }
+        }
+    }
+}
@@ -0,0 +1,166 @@
+
+#ifndef FINALPROJECTV2_OPLATENCY_H
+#define FINALPROJECTV2_OPLATENCY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define OP_LATENCY_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define OP_LATENCY_TSC 1
+#else
+#define OP_LATENCY_TSC 0
+#endif
+
+// Log-linear latency histogram in the style of HdrHistogram: values below 32 get a bucket each,
+// every power-of-two range above that is split into 32 buckets, so any recorded value is
+// reported within about 3% of its true value. The buckets are atomics written only by the
+// owning thread (load + store, no read-modify-write), which lets another thread merge them
+// while recording goes on.
+struct LatencyHistogram {
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKETS = (65 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> maxValue;
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    static int bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<int>(value);
+        int magnitude = 63 - countLeadingZeros(value);
+        int shift = magnitude - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+    }
+
+    // Largest value that lands in bucket `index`.
+    static uint64_t bucketUpperValue(int index) {
+        if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t low = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return low + ((uint64_t(1) << shift) - 1);
+    }
+
+    // Single-writer update: only the thread that owns this histogram may call it.
+    void record(uint64_t value) {
+        std::atomic<uint64_t>& bucket = counts[bucketIndex(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (value > maxValue.load(std::memory_order_relaxed)) maxValue.store(value, std::memory_order_relaxed);
+    }
+
+    void merge(const LatencyHistogram& other);
+    void reset();
+    uint64_t count() const;
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+    // Upper bound of the bucket holding the value at quantile q (0..1); 0 when empty.
+    uint64_t valueAtQuantile(double q) const;
+
+private:
+    static int countLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return 63 - static_cast<int>(index);
+#else
+        return __builtin_clzll(value);
+#endif
+    }
+};
+
+// Optional per-operation latency timing for the public tree operations. Off by default; while
+// off, an OpLatency::Timer costs one relaxed atomic load. While on, every `sampleEvery`-th call
+// on each thread reads the TSC (steady_clock where there is none) on entry and exit and records
+// the difference into a histogram owned by that thread. report() and summarize() merge the
+// histograms of all threads, including ones that have exited.
+//
+// Sampling is what keeps the overhead low: reading the clock around a call stops the CPU from
+// overlapping that call's cache misses with its neighbours', which costs far more than the
+// clock read itself (timing every search of a 1M-key red-black tree more than doubled its
+// cost). bench/latency_bench measures the overhead at the default interval.
+namespace OpLatency {
+    enum Op : uint8_t {
+        BST_INSERT,
+        BST_SEARCH,
+        BST_DELETE,
+        BST_RANGE,
+        BST_KTH,
+        RB_INSERT,
+        RB_SEARCH,
+        RB_DELETE,
+        BTREE_INSERT,
+        BTREE_SEARCH,
+        BTREE_DELETE,
+        OP_COUNT
+    };
+
+    struct Summary {
+        uint64_t count = 0;
+        double p50Ns = 0;
+        double p99Ns = 0;
+        double p999Ns = 0;
+        double maxNs = 0;
+    };
+
+    const uint32_t DEFAULT_SAMPLE_INTERVAL = 128;
+
+    extern std::atomic<bool> timingEnabled;
+    extern std::atomic<uint32_t> sampleInterval;
+    // Per operation, so an operation that always runs right after another (a delete after its
+    // search) is not starved of samples.
+    inline thread_local uint32_t callsUntilSample[OP_COUNT] = {};
+
+    // Turning timing on the first time calibrates the TSC against steady_clock (about 20 ms).
+    // sampleEvery = 1 times every call.
+    void setEnabled(bool enabled, uint32_t sampleEvery = DEFAULT_SAMPLE_INTERVAL);
+    inline bool enabled() { return timingEnabled.load(std::memory_order_relaxed); }
+
+    inline bool sampleThisCall(Op op) {
+        if (!enabled()) return false;
+        if (callsUntilSample[op] != 0) {
+            --callsUntilSample[op];
+            return false;
+        }
+        callsUntilSample[op] = sampleInterval.load(std::memory_order_relaxed) - 1;
+        return true;
+    }
+
+    const char* name(Op op);
+    void record(Op op, uint64_t ticks);
+    Summary summarize(Op op);
+    // One line per operation that has samples: sample count, p50, p99, p99.9 and max in nanoseconds.
+    void report(std::ostream& out);
+    // Clears every thread's histograms. Samples recorded concurrently with a reset may survive it.
+    void reset();
+
+    inline uint64_t now() {
+#if OP_LATENCY_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Times the enclosing scope as one `op` when timing is on and this call is sampled.
+    struct Timer {
+        Op op;
+        uint64_t start;
+
+        explicit Timer(Op op) : op(op), start(sampleThisCall(op) ? now() : 0) {}
+        ~Timer() {
+            if (start != 0) record(op, now() - start);
+        }
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+}
+
+#endif //FINALPROJECTV2_OPLATENCY_H
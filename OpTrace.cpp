@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <cstring>
+#include "OpTrace.h"
+#include "TreeSnapshot.h"
+
+using namespace std;
+
+namespace OpTrace {
+    bool active = false;
+
+    namespace {
+        const char MAGIC[4] = {'A', 'D', 'S', 'T'};
+        const uint8_t VERSION = 1;
+        const size_t HEADER_SIZE = 8;
+        const size_t FLUSH_SIZE = 1 << 16;
+
+        const char* const NAMES[OP_COUNT] = {
+                "tree", "insert", "delete", "search", "min", "max", "successor", "predecessor",
+                "kth", "kthlargest", "range", "inorder", "depth", "count",
+        };
+
+        FILE* file = nullptr;
+        vector<unsigned char> buffer;
+        bool failed = false;
+        uint32_t previousKey = 0;
+
+        void putVarint(vector<unsigned char>& out, uint32_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<unsigned char>(value));
+        }
+
+        bool getVarint(const unsigned char*& p, const unsigned char* end, uint32_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 35 && p < end; shift += 7) {
+                unsigned char byte = *p++;
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (byte < 0x80) return true;
+            }
+            return false;
+        }
+
+        uint32_t zigzag(int32_t value) {
+            return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        }
+
+        int32_t unzigzag(uint32_t value) {
+            return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+        }
+
+        void putKey(int key, uint32_t& previous) {
+            uint32_t value = static_cast<uint32_t>(key);
+            putVarint(buffer, zigzag(static_cast<int32_t>(value - previous)));
+            previous = value;
+        }
+
+        bool getKey(const unsigned char*& p, const unsigned char* end, uint32_t& previous, int& key) {
+            uint32_t value;
+            if (!getVarint(p, end, value)) return false;
+            previous += static_cast<uint32_t>(unzigzag(value));
+            key = static_cast<int>(previous);
+            return true;
+        }
+
+        void writeBuffer() {
+            if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                failed = true;
+            }
+            buffer.clear();
+        }
+    }
+
+    bool start(const string& path) {
+        stop();
+        file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        buffer.assign(HEADER_SIZE, 0);
+        memcpy(buffer.data(), MAGIC, 4);
+        buffer[4] = VERSION;
+        failed = false;
+        previousKey = 0;
+        active = true;
+        return true;
+    }
+
+    bool stop() {
+        if (file == nullptr) return true;
+        writeBuffer();
+        bool ok = fclose(file) == 0 && !failed;
+        file = nullptr;
+        active = false;
+        return ok;
+    }
+
+    void append(Op op, int key, int high) {
+        buffer.push_back(op);
+        switch (op) {
+            case TREE:
+                putVarint(buffer, zigzag(key));
+                putVarint(buffer, zigzag(high));
+                break;
+            case KTH:
+            case KTH_LARGEST:
+                putVarint(buffer, zigzag(key));
+                break;
+            case RANGE:
+                putKey(key, previousKey);
+                putKey(high, previousKey);
+                break;
+            case INSERT:
+            case DELETE:
+            case SEARCH:
+            case SUCCESSOR:
+            case PREDECESSOR:
+                putKey(key, previousKey);
+                break;
+            default:
+                break;
+        }
+        if (buffer.size() >= FLUSH_SIZE) writeBuffer();
+    }
+
+    const char* name(Op op) {
+        return op < OP_COUNT ? NAMES[op] : "unknown";
+    }
+
+    bool read(const string& path, vector<Record>& records) {
+        vector<unsigned char> image;
+        if (!TreeSnapshot::readFile(path, image)) return false;
+        if (image.size() < HEADER_SIZE || memcmp(image.data(), MAGIC, 4) != 0 || image[4] != VERSION) {
+            return false;
+        }
+
+        const unsigned char* p = image.data() + HEADER_SIZE;
+        const unsigned char* end = image.data() + image.size();
+        uint32_t previous = 0;
+        while (p < end) {
+            Record record = {static_cast<Op>(*p++), 0, 0};
+            uint32_t value;
+            bool ok = true;
+            switch (record.op) {
+                case TREE:
+                    ok = getVarint(p, end, value);
+                    record.key = unzigzag(value);
+                    ok = ok && getVarint(p, end, value);
+                    record.high = unzigzag(value);
+                    break;
+                case KTH:
+                case KTH_LARGEST:
+                    ok = getVarint(p, end, value);
+                    record.key = unzigzag(value);
+                    break;
+                case RANGE:
+                    ok = getKey(p, end, previous, record.key) && getKey(p, end, previous, record.high);
+                    break;
+                case INSERT:
+                case DELETE:
+                case SEARCH:
+                case SUCCESSOR:
+                case PREDECESSOR:
+                    ok = getKey(p, end, previous, record.key);
+                    break;
+                case MIN:
+                case MAX:
+                case INORDER:
+                case DEPTH:
+                case COUNT:
+                    break;
+                default:
+                    ok = false;
+            }
+            if (!ok) return false;
+            records.push_back(record);
+        }
+        return true;
+    }
+}
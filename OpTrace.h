@@ -0,0 +1,67 @@
+
+#ifndef FINALPROJECTV2_OPTRACE_H
+#define FINALPROJECTV2_OPTRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Operation traces: a compact binary log of the tree operations issued through the menus or
+// batch mode, so a real operation mix can be replayed elsewhere (bench/trace_replay) without
+// shipping the data behind it. Displays, diagnostics, save and load are not recorded; a trace
+// of a session that loaded a snapshot replays against the trees its own inserts built.
+//
+// Layout: magic "ADST" | version (1) | reserved (3) | records. A record is its opcode byte and
+// then its arguments as LEB128 varints: keys as the zigzag-encoded difference from the previous
+// key in the trace, so nearby keys cost a byte or two, and k, the tree kind and the degree as
+// plain zigzag values.
+namespace OpTrace {
+    enum Op : uint8_t {
+        TREE,           // switch to a new, empty tree: key is the TreeKind, high the B-Tree degree
+        INSERT,
+        DELETE,
+        SEARCH,
+        MIN,
+        MAX,
+        SUCCESSOR,
+        PREDECESSOR,
+        KTH,            // key is k (1-based)
+        KTH_LARGEST,
+        RANGE,          // keys in [key, high]
+        INORDER,
+        DEPTH,
+        COUNT,
+        OP_COUNT
+    };
+
+    enum TreeKind : uint8_t {
+        BST,
+        RED_BLACK,
+        BTREE
+    };
+
+    struct Record {
+        Op op;
+        int key;
+        int high;
+    };
+
+    extern bool active;
+
+    // Starts writing a new trace to `path`; false if the file cannot be created.
+    bool start(const std::string& path);
+    // Writes out what is buffered and closes the trace; false if any write failed.
+    bool stop();
+    inline bool recording() { return active; }
+
+    void append(Op op, int key, int high);
+
+    inline void record(Op op, int key = 0, int high = 0) {
+        if (active) append(op, key, high);
+    }
+
+    const char* name(Op op);
+    bool read(const std::string& path, std::vector<Record>& records);
+}
+
+#endif //FINALPROJECTV2_OPTRACE_H
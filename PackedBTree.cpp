@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <cstring>
+#include "PackedBTree.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+TreeStats PackedBTree::stats;
+
+namespace {
+    // Leaf searches narrow the range by binary search until this many values remain, then
+    // unpack and compare them all at once.
+    const size_t WINDOW = 16;
+
+    // Little-endian 8-byte access, so bit i of the packed stream is bit i % 8 of byte i / 8 on
+    // every host.
+    uint64_t load64(const unsigned char* p) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+    }
+
+    void store64(unsigned char* p, uint64_t word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        memcpy(p, &word, sizeof(word));
+    }
+
+    // Number of the WINDOW values below target.
+    size_t countBelow(const uint32_t* values, uint32_t target) {
+#ifdef __SSE2__
+        // SSE2 only compares signed ints; flipping the sign bit maps unsigned order onto it.
+        const __m128i bias = _mm_set1_epi32(INT32_MIN);
+        const __m128i limit = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(target)), bias);
+        int below = 0;
+        for (size_t i = 0; i < WINDOW; i += 4) {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), bias);
+            below += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, limit))));
+        }
+        return below;
+#else
+        size_t below = 0;
+        for (size_t i = 0; i < WINDOW; i++) {
+            below += values[i] < target;
+        }
+        return below;
+#endif
+    }
+
+    void deleteNodes(PackedBTreeNode* node) {
+        if (node == nullptr) return;
+
+        for (PackedBTreeNode* child : node->children) {
+            deleteNodes(child);
+        }
+        delete node;
+    }
+
+    size_t nodeMemory(const PackedBTreeNode* node) {
+        size_t bytes = sizeof(PackedBTreeNode) + node->packed.capacity() + node->separators.capacity() * sizeof(int) +
+                       node->children.capacity() * sizeof(PackedBTreeNode*);
+        for (const PackedBTreeNode* child : node->children) {
+            bytes += nodeMemory(child);
+        }
+        return bytes;
+    }
+
+    size_t payloadBytes(const PackedBTreeNode* node) {
+        if (node->isLeaf) return (static_cast<size_t>(node->count) * node->bits + 7) / 8;
+        size_t bytes = 0;
+        for (const PackedBTreeNode* child : node->children) {
+            bytes += payloadBytes(child);
+        }
+        return bytes;
+    }
+
+    void collectKeysInOrder(const PackedBTreeNode* node, vector<int>& out) {
+        if (node->isLeaf) {
+            size_t first = out.size();
+            out.resize(first + node->count);
+            node->decode(out.data() + first);
+            return;
+        }
+        for (const PackedBTreeNode* child : node->children) {
+            collectKeysInOrder(child, out);
+        }
+    }
+}
+
+PackedBTreeNode::PackedBTreeNode(bool isLeaf) : isLeaf(isLeaf), base(0), bits(0), count(0) {}
+
+uint32_t PackedBTreeNode::delta(size_t i) const {
+    size_t bit = i * bits;
+    return static_cast<uint32_t>((load64(&packed[bit >> 3]) >> (bit & 7)) & ((uint64_t(1) << bits) - 1));
+}
+
+size_t PackedBTreeNode::lowerBound(int key) const {
+    if (count == 0 || key <= base) return 0;
+    uint64_t target = static_cast<uint64_t>(static_cast<int64_t>(key) - base);
+    if (bits < 32 && (target >> bits) != 0) return count;
+
+    size_t lo = 0, len = count;
+    while (len > WINDOW) {
+        size_t half = len / 2;
+        TREE_STAT(PackedBTree::stats.comparisons++);
+        lo = delta(lo + half - 1) < target ? lo + half : lo;
+        len -= half;
+    }
+    uint32_t values[WINDOW];
+    for (size_t i = 0; i < WINDOW; i++) {
+        values[i] = i < len ? delta(lo + i) : UINT32_MAX;
+    }
+    TREE_STAT(PackedBTree::stats.comparisons += len);
+    return lo + countBelow(values, static_cast<uint32_t>(target));
+}
+
+void PackedBTreeNode::decode(int* out) const {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = key(i);
+    }
+}
+
+void PackedBTreeNode::encode(const int* keys, size_t n) {
+    count = static_cast<uint32_t>(n);
+    base = n == 0 ? 0 : keys[0];
+    uint32_t range = n == 0 ? 0 : static_cast<uint32_t>(static_cast<int64_t>(keys[n - 1]) - base);
+    bits = static_cast<uint8_t>(range == 0 ? 0 : 32 - __builtin_clz(range));
+
+    vector<unsigned char> out((n * bits + 7) / 8 + sizeof(uint64_t), 0);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t value = static_cast<uint32_t>(static_cast<int64_t>(keys[i]) - base);
+        size_t bit = i * bits;
+        store64(&out[bit >> 3], load64(&out[bit >> 3]) | (value << (bit & 7)));
+    }
+    packed.swap(out);
+}
+
+PackedBTree::PackedBTree(int leafKeys, int fanout) : root(nullptr), leafKeys(leafKeys), fanout(fanout), count(0) {}
+
+PackedBTree::~PackedBTree() {
+    clear();
+}
+
+PackedBTreeNode* PackedBTree::findLeaf(int key) const {
+    PackedBTreeNode* node = root;
+    while (!node->isLeaf) {
+        TREE_STAT(stats.nodesVisited++);
+        node = node->children[upper_bound(node->separators.begin(), node->separators.end(), key) -
+                              node->separators.begin()];
+    }
+    TREE_STAT(stats.nodesVisited++);
+    return node;
+}
+
+bool PackedBTree::contains(int key) const {
+    TREE_STAT(stats.searches++);
+    if (root == nullptr) return false;
+    const PackedBTreeNode* leaf = findLeaf(key);
+    size_t pos = leaf->lowerBound(key);
+    return pos < leaf->count && leaf->key(pos) == key;
+}
+
+bool PackedBTree::insert(int key) {
+    if (root == nullptr) {
+        root = new PackedBTreeNode(true);
+    }
+    int separator;
+    PackedBTreeNode* right = nullptr;
+    if (!insertInto(root, key, separator, right)) return false;
+
+    if (right != nullptr) {
+        PackedBTreeNode* top = new PackedBTreeNode(false);
+        top->separators = {separator};
+        top->children = {root, right};
+        root = top;
+    }
+    count++;
+    return true;
+}
+
+bool PackedBTree::insertInto(PackedBTreeNode* node, int key, int& separator, PackedBTreeNode*& right) {
+    if (node->isLeaf) {
+        size_t pos = node->lowerBound(key);
+        if (pos < node->count && node->key(pos) == key) return false;
+
+        vector<int> keys(node->count + 1);
+        node->decode(keys.data());
+        move_backward(keys.begin() + pos, keys.end() - 1, keys.end());
+        keys[pos] = key;
+        if (keys.size() > static_cast<size_t>(leafKeys)) {
+            TREE_STAT(stats.splits++);
+            size_t mid = keys.size() / 2;
+            right = new PackedBTreeNode(true);
+            right->encode(keys.data() + mid, keys.size() - mid);
+            separator = keys[mid];
+            node->encode(keys.data(), mid);
+        } else {
+            node->encode(keys.data(), keys.size());
+        }
+        return true;
+    }
+
+    size_t i = upper_bound(node->separators.begin(), node->separators.end(), key) - node->separators.begin();
+    int childSeparator;
+    PackedBTreeNode* childRight = nullptr;
+    if (!insertInto(node->children[i], key, childSeparator, childRight)) return false;
+    if (childRight == nullptr) return true;
+
+    node->separators.insert(node->separators.begin() + i, childSeparator);
+    node->children.insert(node->children.begin() + i + 1, childRight);
+    if (node->children.size() > static_cast<size_t>(fanout)) {
+        TREE_STAT(stats.splits++);
+        size_t mid = node->separators.size() / 2;
+        right = new PackedBTreeNode(false);
+        separator = node->separators[mid];
+        right->separators.assign(node->separators.begin() + mid + 1, node->separators.end());
+        right->children.assign(node->children.begin() + mid + 1, node->children.end());
+        node->separators.resize(mid);
+        node->children.resize(mid + 1);
+    }
+    return true;
+}
+
+bool PackedBTree::erase(int key) {
+    if (root == nullptr) return false;
+    PackedBTreeNode* leaf = findLeaf(key);
+    size_t pos = leaf->lowerBound(key);
+    if (pos >= leaf->count || leaf->key(pos) != key) return false;
+
+    vector<int> keys(leaf->count);
+    leaf->decode(keys.data());
+    keys.erase(keys.begin() + pos);
+    leaf->encode(keys.data(), keys.size());
+    count--;
+    return true;
+}
+
+// Cuts each level into the fewest nodes that respect the capacity, sized within one of each
+// other, so leaves come out full and every later insert into one splits it.
+void PackedBTree::buildFromSorted(const vector<int>& keys) {
+    clear();
+    if (keys.empty()) return;
+
+    vector<PackedBTreeNode*> level;
+    vector<int> firstKeys;
+    size_t leaves = (keys.size() + leafKeys - 1) / leafKeys;
+    size_t pos = 0;
+    for (size_t i = 0; i < leaves; i++) {
+        size_t size = keys.size() / leaves + (i < keys.size() % leaves ? 1 : 0);
+        PackedBTreeNode* leaf = new PackedBTreeNode(true);
+        leaf->encode(keys.data() + pos, size);
+        level.push_back(leaf);
+        firstKeys.push_back(keys[pos]);
+        pos += size;
+    }
+
+    while (level.size() > 1) {
+        size_t parents = (level.size() + fanout - 1) / fanout;
+        vector<PackedBTreeNode*> upper;
+        vector<int> upperFirstKeys;
+        size_t child = 0;
+        for (size_t i = 0; i < parents; i++) {
+            size_t size = level.size() / parents + (i < level.size() % parents ? 1 : 0);
+            PackedBTreeNode* node = new PackedBTreeNode(false);
+            node->children.assign(level.begin() + child, level.begin() + child + size);
+            node->separators.assign(firstKeys.begin() + child + 1, firstKeys.begin() + child + size);
+            upper.push_back(node);
+            upperFirstKeys.push_back(firstKeys[child]);
+            child += size;
+        }
+        level.swap(upper);
+        firstKeys.swap(upperFirstKeys);
+    }
+    root = level[0];
+    count = keys.size();
+}
+
+int PackedBTree::depth() const {
+    int levels = 0;
+    for (const PackedBTreeNode* node = root; node != nullptr; node = node->isLeaf ? nullptr : node->children[0]) {
+        levels++;
+    }
+    return levels;
+}
+
+size_t PackedBTree::memoryUsage() const {
+    return root == nullptr ? 0 : nodeMemory(root);
+}
+
+size_t PackedBTree::leafPayloadBytes() const {
+    return root == nullptr ? 0 : payloadBytes(root);
+}
+
+void PackedBTree::collectKeys(vector<int>& out) const {
+    out.reserve(out.size() + count);
+    if (root != nullptr) collectKeysInOrder(root, out);
+}
+
+void PackedBTree::clear() {
+    deleteNodes(root);
+    root = nullptr;
+    count = 0;
+}
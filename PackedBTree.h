@@ -0,0 +1,75 @@
+
+#ifndef FINALPROJECTV2_PACKEDBTREE_H
+#define FINALPROJECTV2_PACKEDBTREE_H
+
+#include <cstdint>
+#include <vector>
+#include "TreeStats.h"
+
+// Node of a PackedBTree. A leaf stores its sorted keys frame-of-reference encoded: `base` is the
+// smallest key and every key is kept as key - base in `bits` bits, packed back to back in
+// `packed` (plus 8 bytes of padding so any value can be read with one 8-byte load). Internal
+// nodes route with plain separators: children[i] holds the keys k with
+// separators[i - 1] <= k < separators[i].
+struct PackedBTreeNode {
+    bool isLeaf;
+
+    int base;
+    uint8_t bits;
+    uint32_t count;
+    std::vector<unsigned char> packed;
+
+    std::vector<int> separators;
+    std::vector<PackedBTreeNode*> children;
+
+    explicit PackedBTreeNode(bool isLeaf);
+
+    // Offset of keys[i] from base.
+    uint32_t delta(size_t i) const;
+    int key(size_t i) const { return static_cast<int>(static_cast<int64_t>(base) + delta(i)); }
+    // Index of the first key not below `key`.
+    size_t lowerBound(int key) const;
+    void decode(int* out) const;
+    void encode(const int* keys, size_t n);
+};
+
+// B+-Tree over int keys with bit-packed leaves, for dense, mostly increasing keys where a 32-bit
+// slot per key mostly stores zeros: keys 3 apart in a 256-key leaf need 10 bits each. A leaf
+// search binary-searches the packed values in place and finishes with a branch-free compare over
+// the last few unpacked values.
+//
+// Changing a leaf decodes and re-encodes it, so inserts cost O(leafKeys); buildFromSorted()
+// packs full leaves directly. Keys are unique, and erase() does not merge underfull nodes.
+struct PackedBTree {
+    static TreeStats stats;
+
+    PackedBTreeNode* root;
+    int leafKeys;       // keys per leaf before it splits
+    int fanout;         // children per internal node before it splits
+
+    explicit PackedBTree(int leafKeys = 256, int fanout = 64);
+    ~PackedBTree();
+
+    PackedBTree(const PackedBTree&) = delete;
+    PackedBTree& operator=(const PackedBTree&) = delete;
+
+    bool insert(int key);           // false if the key was already present
+    bool contains(int key) const;
+    bool erase(int key);            // false if the key was not present
+
+    size_t keyCount() const { return count; }
+    int depth() const;
+    size_t memoryUsage() const;     // bytes held by nodes, including spare capacity
+    size_t leafPayloadBytes() const; // packed key bytes alone, without padding and node headers
+    void collectKeys(std::vector<int>& out) const;
+    void buildFromSorted(const std::vector<int>& keys);    // sorted, without duplicates
+    void clear();
+
+private:
+    size_t count;
+
+    PackedBTreeNode* findLeaf(int key) const;
+    bool insertInto(PackedBTreeNode* node, int key, int& separator, PackedBTreeNode*& right);
+};
+
+#endif //FINALPROJECTV2_PACKEDBTREE_H
@@ -0,0 +1,156 @@
+
+#ifndef FINALPROJECTV2_PARALLELTRAVERSAL_H
+#define FINALPROJECTV2_PARALLELTRAVERSAL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <vector>
+#include "BSTOperations.h"
+#include "BTreeOperations.h"
+#include "RBTreeOperations.h"
+#include "TaskPool.h"
+
+// Parallel traversals over the trees on a TaskPool. Each node checks whether the pool wants work
+// (TaskPool::wantsTasks); if so, its children become tasks, otherwise it recurses serially. A
+// subtree is therefore split again whenever thieves have drained what its participant offered,
+// which balances lopsided BSTrees. A balanced tree costs a few tasks per participant, and B-Tree
+// nodes fan out across all their children. The tree must not change during a traversal.
+//
+// forEachChild(node, f) calls f(child) for every real child (not nullptr, not NIL) in order.
+
+template <typename T, typename Node, typename ForEachChild, typename Visit, typename Combine>
+struct TreeReduction {
+    TaskPool& pool;
+    T identity;
+    ForEachChild forEachChild;
+    Visit visit;
+    Combine combine;
+
+    T reduce(Node* node) const {
+        if (pool.wantsTasks()) return split(node);
+        T children = identity;
+        forEachChild(node, [&](Node* child) { children = combine(children, reduce(child)); });
+        return visit(node, children);
+    }
+
+    // Kept out of line so that the serial path above stays a small frame.
+    __attribute__((noinline)) T split(Node* node) const {
+        T children = identity;
+        std::vector<Node*> kids;
+        forEachChild(node, [&](Node* child) { kids.push_back(child); });
+        std::vector<T> results(kids.size(), identity);
+        TaskPool::Group group;
+        for (size_t i = 1; i < kids.size(); i++) {
+            pool.spawn(group, [this, &kids, &results, i] { results[i] = reduce(kids[i]); });
+        }
+        // The spawned tasks write to kids and results, so wait for them even if the first child throws.
+        std::exception_ptr error;
+        try {
+            if (!kids.empty()) results[0] = reduce(kids[0]);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        pool.wait(group);
+        if (error) std::rethrow_exception(error);
+        for (const T& result : results) {
+            children = combine(children, result);
+        }
+        return visit(node, children);
+    }
+};
+
+// Bottom-up fold over the subtree of `root` (nullptr for none): each node's result is
+// visit(node, c), where c combines its children's results, starting from `identity`. combine
+// must be associative; the children are combined in order.
+template <typename T, typename Node, typename ForEachChild, typename Visit, typename Combine>
+T parallelReduce(TaskPool& pool, Node* root, T identity, ForEachChild forEachChild, Visit visit, Combine combine) {
+    T result = identity;
+    if (root == nullptr) return result;
+    TreeReduction<T, Node, ForEachChild, Visit, Combine> reduction{pool, identity, forEachChild, visit, combine};
+    pool.run([&] { result = reduction.reduce(root); });
+    return result;
+}
+
+// Calls fn(node) once for every node of the subtree, from any participant and in no fixed order.
+template <typename Node, typename ForEachChild, typename Fn>
+void parallelForEach(TaskPool& pool, Node* root, ForEachChild forEachChild, Fn fn) {
+    parallelReduce(pool, root, 0, forEachChild, [&fn](Node* node, int) { fn(node); return 0; },
+                   [](int, int) { return 0; });
+}
+
+// Child listers for the three trees.
+template <typename Key, typename Value>
+auto bstChildren() {
+    return [](BSTNode<Key, Value>* node, auto&& f) {
+        if (node->left != nullptr) f(node->left);
+        if (node->right != nullptr) f(node->right);
+    };
+}
+
+template <typename Key, typename Value, typename Compare>
+auto rbChildren() {
+    using Tree = BasicRBTree<Key, Value, Compare>;
+    return [](typename Tree::Node* node, auto&& f) {
+        if (node->left != Tree::NIL) f(node->left);
+        if (node->right != Tree::NIL) f(node->right);
+    };
+}
+
+template <typename Key, typename Value, typename Compare>
+auto bTreeChildren() {
+    return [](BasicBTreeNode<Key, Value, Compare>* node, auto&& f) {
+        for (BasicBTreeNode<Key, Value, Compare>* child : node->children) {
+            f(child);
+        }
+    };
+}
+
+// Parallel counterparts of the serial aggregates, with the same results.
+
+template <typename Key, typename Value, typename Compare>
+int parallelDepth(TaskPool& pool, BasicBSTree<Key, Value, Compare>& tree) {
+    return parallelReduce(pool, tree.root, 0, bstChildren<Key, Value>(),
+                          [](BSTNode<Key, Value>*, int depth) { return depth + 1; },
+                          [](int a, int b) { return std::max(a, b); });
+}
+
+template <typename Key, typename Value, typename Compare>
+int parallelDepth(TaskPool& pool, BasicRBTree<Key, Value, Compare>& tree) {
+    using Node = typename BasicRBTree<Key, Value, Compare>::Node;
+    return parallelReduce(pool, tree.root == tree.NIL ? nullptr : tree.root, 0, rbChildren<Key, Value, Compare>(),
+                          [](Node*, int depth) { return depth + 1; }, [](int a, int b) { return std::max(a, b); });
+}
+
+template <typename Key, typename Value, typename Compare>
+int parallelCountBlackNodes(TaskPool& pool, BasicRBTree<Key, Value, Compare>& tree) {
+    using Node = typename BasicRBTree<Key, Value, Compare>::Node;
+    return parallelReduce(pool, tree.root == tree.NIL ? nullptr : tree.root, 0, rbChildren<Key, Value, Compare>(),
+                          [](Node* node, int count) { return count + (node->color == Node::BLACK ? 1 : 0); },
+                          [](int a, int b) { return a + b; });
+}
+
+template <typename Key, typename Value, typename Compare>
+int parallelDepth(TaskPool& pool, BasicBTree<Key, Value, Compare>& tree) {
+    return parallelReduce(pool, tree.root, 0, bTreeChildren<Key, Value, Compare>(),
+                          [](BasicBTreeNode<Key, Value, Compare>*, int depth) { return depth + 1; },
+                          [](int a, int b) { return std::max(a, b); });
+}
+
+template <typename Key, typename Value, typename Compare>
+int parallelKeyCount(TaskPool& pool, BasicBTree<Key, Value, Compare>& tree) {
+    return parallelReduce(pool, tree.root, 0, bTreeChildren<Key, Value, Compare>(),
+                          [](BasicBTreeNode<Key, Value, Compare>* node, int count) {
+                              return count + static_cast<int>(node->keys.size());
+                          },
+                          [](int a, int b) { return a + b; });
+}
+
+template <typename Key, typename Value, typename Compare>
+int parallelCountLeafNodes(TaskPool& pool, BasicBTree<Key, Value, Compare>& tree) {
+    return parallelReduce(pool, tree.root, 0, bTreeChildren<Key, Value, Compare>(),
+                          [](BasicBTreeNode<Key, Value, Compare>* node, int count) { return node->isLeaf ? 1 : count; },
+                          [](int a, int b) { return a + b; });
+}
+
+#endif //FINALPROJECTV2_PARALLELTRAVERSAL_H
@@ -2,6 +2,725 @@
 #ifndef FINALPROJECTV2_RBTREEOPERATIONS_H
 #define FINALPROJECTV2_RBTREEOPERATIONS_H
 
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "FrozenTree.h"
+#include "OpLatency.h"
+#include "TreeSnapshot.h"
+#include "TreeStats.h"
+#include "TreeTraits.h"
+
+template <typename Key, typename Value = NoValue>
+struct BasicRBNode {
+    Key key;
+    Value value;
+    BasicRBNode* parent;
+    BasicRBNode* left;
+    BasicRBNode* right;
+    enum Color { RED, BLACK } color;
+
+    BasicRBNode(Key k = Key(), BasicRBNode* p = nullptr, BasicRBNode* l = nullptr, BasicRBNode* r = nullptr,
+                Color c = BLACK, Value v = Value())
+            : key(std::move(k)), value(std::move(v)), parent(p), left(l), right(r), color(c) {}
+
+    std::string toString() {
+        return std::to_string(key) + (color == RED ? ":r" : ":b");
+    }
+};
+
+// Red-black tree mapping Key to Value; see TreeTraits.h for the parameters. Every instantiation
+// has one shared black sentinel, NIL, standing in for all leaves and the root's parent.
+template <typename Key, typename Value = NoValue, typename Compare = std::less<Key>, typename Augment = NoAugment>
+struct BasicRBTree {
+    using Node = BasicRBNode<Key, Value>;
+    using KeyType = Key;
+    using CompareType = Compare;
+
+    static constexpr bool AUGMENTED = !std::is_same<Augment, NoAugment>::value;
+
+    static inline Node sentinel;
+    static inline Node* const NIL = &sentinel;
+    static inline TreeStats stats;
+
+    Node* root;
+    size_t nodeCount;
+    Node* leftmost;     // the node with the smallest key, NIL when empty; rotations keep it
+    Node* rightmost;    // the node with the largest key, NIL when empty
+
+    BasicRBTree() : root(NIL), nodeCount(0), leftmost(NIL), rightmost(NIL) {}
+    ~BasicRBTree() { deleteSubtree(root); }
+    BasicRBTree(const BasicRBTree&) = delete;
+    BasicRBTree& operator=(const BasicRBTree&) = delete;
+
+    Node* RBInsert(Key key, Value value = Value()) {
+        OpLatency::Timer timer(OpLatency::RB_INSERT);
+        Node* z = new Node(std::move(key), nullptr, NIL, NIL, Node::RED, std::move(value));
+        Node* y = NIL;
+        Node* x = root;
+        bool onlyLeft = true, onlyRight = true;
+
+        while (x != NIL) {
+            y = x;
+            if (before(z->key, x->key)) {
+                x = x->left;
+                onlyRight = false;
+            } else {
+                x = x->right;
+                onlyLeft = false;
+            }
+        }
+        z->parent = y;
+        if (y == NIL)
+            root = z;
+        else if (before(z->key, y->key))
+            y->left = z;
+        else
+            y->right = z;
+
+        z->left = z->right = NIL;
+        if (onlyLeft) leftmost = z;
+        if (onlyRight) rightmost = z;
+        augmentPath(z);
+        RBInsertFixup(z);
+        nodeCount++;
+        return z;
+    }
+
+    void RBDelete(Node* z) {
+        OpLatency::Timer timer(OpLatency::RB_DELETE);
+        Node* y = z;
+        Node* x;
+        typename Node::Color yOriginalColor = y->color;
+
+        // The extremes have at most one child, so their in-order neighbour is that child's
+        // subtree or their parent.
+        if (z == leftmost) leftmost = z->right != NIL ? minimum(z->right) : z->parent;
+        if (z == rightmost) rightmost = z->left != NIL ? maximum(z->left) : z->parent;
+
+        if (z->left == NIL) {
+            x = z->right;
+            if (z->parent == NIL)
+                root = x;
+            else if (z == z->parent->left)
+                z->parent->left = x;
+            else
+                z->parent->right = x;
+            x->parent = z->parent;
+        } else if (z->right == NIL) {
+            x = z->left;
+            if (z->parent == NIL)
+                root = x;
+            else if (z == z->parent->left)
+                z->parent->left = x;
+            else
+                z->parent->right = x;
+            x->parent = z->parent;
+        } else {
+            y = minimum(z->right);
+            yOriginalColor = y->color;
+            x = y->right;
+
+            if (y->parent == z) {
+                x->parent = y;
+            } else {
+                if (y->parent != NIL)
+                    y->parent->left = x;
+                x->parent = y->parent;
+                y->right = z->right;
+                y->right->parent = y;
+            }
+
+            if (z->parent == NIL)
+                root = y;
+            else if (z == z->parent->left)
+                z->parent->left = y;
+            else
+                z->parent->right = y;
+
+            y->parent = z->parent;
+            y->left = z->left;
+            y->left->parent = y;
+            y->color = z->color;
+        }
+
+        delete z;
+        nodeCount--;
+
+        // x->parent is set even when x is NIL, and it is the lowest node whose subtree changed.
+        augmentPath(x->parent);
+        if (yOriginalColor == Node::BLACK) {
+            RBDeleteFixup(x);
+        }
+    }
+
+    // Removes one entry equivalent to `key`; false if there is none.
+    bool erase(const Key& key) {
+        Node* z = searchFrom(root, key);
+        if (z == NIL) return false;
+        RBDelete(z);
+        return true;
+    }
+
+    // Removes one entry per element of `keys`, which must be sorted (a key listed twice removes
+    // two copies), and returns how many were found. How much the batch saves over erase() per
+    // key depends on its size relative to the tree:
+    //  - below 1/16 of the tree it is erase() per key in key order, which only gains from
+    //    consecutive descents sharing cached upper levels;
+    //  - up to 3/4, each key is found by a finger search from the successor of the last node
+    //    removed, which climbs only until the subtree above must hold the key, so keys d nodes
+    //    apart cost about O(log d). On sparser batches the climb nearly reaches the root and
+    //    costs more than it saves;
+    //  - a larger batch takes the tree apart: one in-order walk deletes the matching nodes, and
+    //    the survivors are relinked into a balanced tree in place, in O(n) without allocating.
+    size_t eraseBatch(const std::vector<Key>& keys) {
+        if (keys.size() * 4 < nodeCount * 3) {
+            bool nearby = keys.size() * 16 >= nodeCount;
+            size_t removed = 0;
+            Node* finger = NIL;
+            const Key* lastRemoved = nullptr;
+            for (const Key& key : keys) {
+                // Every node left of the finger is at most *lastRemoved, so a key above it can
+                // only be at or right of the finger; a repeated key may be on either side.
+                Node* z = nearby && finger != NIL && before(*lastRemoved, key) ? searchNear(finger, key)
+                                                                                : searchFrom(root, key);
+                if (z == NIL) continue;
+                finger = successor(z);      // RBDelete frees z only, so the successor stays valid
+                lastRemoved = &key;
+                RBDelete(z);
+                removed++;
+            }
+            return removed;
+        }
+
+        std::vector<Node*> survivors;
+        survivors.reserve(nodeCount);
+        size_t next = 0;
+        size_t removed = 0;
+        detachSurvivors(root, keys, next, survivors, removed);
+        nodeCount = survivors.size();
+
+        int levels = 0;
+        for (size_t n = survivors.size(); n > 0; n >>= 1)
+            levels++;
+        root = relinkBalanced(survivors, 0, survivors.size(), NIL, 1, levels > 1 ? levels : 0);
+        leftmost = survivors.empty() ? NIL : survivors.front();
+        rightmost = survivors.empty() ? NIL : survivors.back();
+        return removed;
+    }
+
+    size_t size() const { return nodeCount; }
+
+    // Removes the entry with the smallest / largest key, moving it to *key and *value when those
+    // are not null; false if the tree is empty. The node comes from the cached extreme, so there
+    // is no search, only RBDelete's fixup.
+    bool popMin(Key* key = nullptr, Value* value = nullptr) { return popNode(leftmost, key, value); }
+    bool popMax(Key* key = nullptr, Value* value = nullptr) { return popNode(rightmost, key, value); }
+
+    Node* search(Node* x, const Key& key) { return timedSearch(x, key); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Node* search(Node* x, const K& key) { return timedSearch(x, key); }
+
+    // Sets results[i] to search(root, keys[i]) for every i. The probes are sorted, and each node
+    // splits the sorted run it receives into the probes below, equal to and above its key and
+    // hands the outer runs to its children, so probes with a common path share its descent and
+    // no node is visited twice in a batch. A run down to one probe finishes as a plain search.
+    void multiSearch(const std::vector<Key>& keys, std::vector<Node*>& results) {
+        results.assign(keys.size(), NIL);
+        TREE_STAT(stats.searches += keys.size());
+        std::vector<std::pair<Key, size_t>> probes;
+        probes.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            probes.emplace_back(keys[i], i);
+        }
+        std::sort(probes.begin(), probes.end(), [](const auto& a, const auto& b) { return before(a.first, b.first); });
+
+        struct Run {
+            Node* x;
+            size_t first, last;
+        };
+        std::vector<Run> pending;
+        if (!probes.empty()) pending.push_back({root, 0, probes.size()});
+        while (!pending.empty()) {
+            Run run = pending.back();
+            pending.pop_back();
+            if (run.last - run.first == 1) {
+                results[probes[run.first].second] = searchFrom(run.x, probes[run.first].first);
+                continue;
+            }
+            if (run.x == NIL) continue;
+            TREE_STAT(stats.nodesVisited++);
+            auto first = probes.begin() + run.first;
+            auto last = probes.begin() + run.last;
+            auto equalFirst = std::lower_bound(first, last, run.x->key,
+                                               [](const auto& probe, const Key& key) { return before(probe.first, key); });
+            auto equalLast = std::upper_bound(equalFirst, last, run.x->key,
+                                              [](const Key& key, const auto& probe) { return before(key, probe.first); });
+            for (auto it = equalFirst; it != equalLast; ++it) {
+                results[it->second] = run.x;
+            }
+            if (first != equalFirst) pending.push_back({run.x->left, run.first, size_t(equalFirst - probes.begin())});
+            if (equalLast != last) pending.push_back({run.x->right, size_t(equalLast - probes.begin()), run.last});
+        }
+    }
+
+    // The value stored under `key`, or nullptr.
+    Value* find(const Key& key) { return valueOf(search(root, key)); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value* find(const K& key) { return valueOf(search(root, key)); }
+
+    Value& at(const Key& key) { return checkedValue(find(key)); }
+
+    template <typename K, typename C = Compare, typename = typename C::is_transparent>
+    Value& at(const K& key) { return checkedValue(find(key)); }
+
+    // The smallest / largest node, in O(1) from the cached extremes; NIL when empty.
+    Node* minimum() { return leftmost; }
+    Node* maximum() { return rightmost; }
+
+    Node* minimum(Node* x) {
+        while (x->left != NIL)
+            x = x->left;
+        return x;
+    }
+
+    Node* maximum(Node* x) {
+        while (x->right != NIL)
+            x = x->right;
+        return x;
+    }
+
+    Node* successor(Node* x) {
+        if (x->right != NIL)
+            return minimum(x->right);
+        Node* y = x->parent;
+        while (y != NIL && x == y->right) {
+            x = y;
+            y = y->parent;
+        }
+        return y;
+    }
+
+    Node* predecessor(Node* x) {
+        if (x->left != NIL) {
+            return maximum(x->left);
+        }
+        Node* y = x->parent;
+        while (y != NIL && x == y->left) {
+            x = y;
+            y = y->parent;
+        }
+        return y;
+    }
+
+    void inorder(Node* x) {
+        if (x != NIL) {
+            inorder(x->left);
+            std::cout << x->toString() << " ";
+            inorder(x->right);
+        }
+    }
+
+    void indentedDisplay(Node* x, int indent) {
+        if (x != NIL) {
+            indentedDisplay(x->right, indent + 4);
+            if (indent > 0)
+                std::cout << std::string(indent, ' ');
+            std::cout << x->toString() << std::endl;
+            indentedDisplay(x->left, indent + 4);
+        }
+    }
+
+    int blackHeight(Node* x) {
+        if (x == NIL)
+            return 0;
+        int leftHeight = blackHeight(x->left);
+        int rightHeight = blackHeight(x->right);
+        return (x->color == Node::BLACK ? 1 : 0) + std::max(leftHeight, rightHeight);
+    }
+
+    // The black / red node with the largest key, or nullptr when there is none.
+    Node* maximumBlack() { return maximumColored(root, Node::BLACK); }
+    Node* maximumRed() { return maximumColored(root, Node::RED); }
+
+    int calculateDepth(Node* node) {
+        if (node == NIL) return 0;
+
+        int leftDepth = calculateDepth(node->left);
+        int rightDepth = calculateDepth(node->right);
+
+        return 1 + std::max(leftDepth, rightDepth);
+    }
+
+    int depth() { return calculateDepth(root); }
+
+    double blackNodePercentage() {
+        int totalBlackNodes = countBlackNodes();
+        int totalNodes = totalNodesHelper(root);
+
+        if (totalNodes == 0) return 0.0;
+
+        return (static_cast<double>(totalBlackNodes) / totalNodes) * 100.0;
+    }
+
+    // The black / red node with the smallest key, or nullptr when there is none.
+    Node* minimumRed() { return minimumColored(root, Node::RED); }
+    Node* minimumBlack() { return minimumColored(root, Node::BLACK); }
+
+    // Keys on the path from the root to `key`; empty when the key is not in the tree.
+    std::vector<Key> pathToKey(const Key& key) {
+        std::vector<Key> path;
+        for (Node* x = root; x != NIL; x = before(key, x->key) ? x->left : x->right) {
+            path.push_back(x->key);
+            if (!before(key, x->key) && !before(x->key, key)) return path;
+        }
+        return {};
+    }
+
+    int countRedNodes() {return countRedNodesHelper(root);}
+    void inorder() { inorder(root); }
+    void indentedDisplay() { indentedDisplay(root, 0); }
+    int blackHeight() { return blackHeight(root); }
+    int countBlackNodes() { return countBlackNodesHelper(root); }
+
+    void collectKeys(Node* x, std::vector<Key>& out) {
+        if (x != NIL) {
+            collectKeys(x->left, out);
+            out.push_back(x->key);
+            collectKeys(x->right, out);
+        }
+    }
+
+    // Read-only copy of the current keys for search-heavy phases; see FrozenTree.h.
+    FrozenTree<Key, Compare> freeze() {
+        std::vector<Key> keys;
+        collectKeys(root, keys);
+        return FrozenTree<Key, Compare>(keys);
+    }
+
+    // Snapshots hold int keys only (TreeSnapshot.h).
+    bool save(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        collectKeys(root, keys);
+        return TreeSnapshot::write(path, TreeSnapshot::RED_BLACK, keys);
+    }
+
+    bool load(const std::string& path) {
+        static_assert(std::is_same<Key, int>::value, "snapshots store int keys");
+        std::vector<int> keys;
+        if (!TreeSnapshot::read(path, TreeSnapshot::RED_BLACK, keys))
+            return false;
+        deleteSubtree(root);
+
+        int levels = 0;
+        for (size_t n = keys.size(); n > 0; n >>= 1)
+            levels++;
+        root = buildBalanced(keys, 0, keys.size(), NIL, 1, levels > 1 ? levels : 0);
+        nodeCount = keys.size();
+        leftmost = root == NIL ? NIL : minimum(root);
+        rightmost = root == NIL ? NIL : maximum(root);
+        return true;
+    }
+
+
+private:
+    template <typename A, typename B>
+    static bool before(const A& a, const B& b) { return Compare()(a, b); }
+
+    template <typename K>
+    Node* timedSearch(Node* x, const K& key) {
+        OpLatency::Timer timer(OpLatency::RB_SEARCH);
+        TREE_STAT(stats.searches++);
+        return searchFrom(x, key);
+    }
+
+    template <typename K>
+    Node* searchFrom(Node* x, const K& key) {
+        while (x != NIL) {
+            TREE_STAT(stats.nodesVisited++; stats.comparisons++);
+            if (before(key, x->key)) {
+                x = x->left;
+            } else {
+                TREE_STAT(stats.comparisons++);
+                if (!before(x->key, key)) return x;
+                x = x->right;
+            }
+        }
+        return NIL;
+    }
+
+    static Value* valueOf(Node* x) { return x == NIL ? nullptr : &x->value; }
+
+    static void augment(Node* x) {
+        if constexpr (AUGMENTED) Augment()(x, NIL);
+    }
+
+    // Recomputes the Augment cache of x and its ancestors after x's subtree changed.
+    static void augmentPath(Node* x) {
+        if constexpr (AUGMENTED) {
+            for (; x != NIL; x = x->parent)
+                Augment()(x, NIL);
+        }
+    }
+
+    bool popNode(Node* z, Key* key, Value* value) {
+        if (z == NIL) return false;
+        if (key != nullptr) *key = std::move(z->key);
+        if (value != nullptr) *value = std::move(z->value);
+        RBDelete(z);
+        return true;
+    }
+
+    static Value& checkedValue(Value* value) {
+        if (value == nullptr) throw std::out_of_range("key not found");
+        return *value;
+    }
+
+    // Median split keeps both subtrees within one node of each other, so every NIL hangs off
+    // one of the two deepest levels. Colouring the deepest level red and the rest black then
+    // gives every path the same black count without any fixup, and the colours need not be stored.
+    Node* buildBalanced(const std::vector<Key>& keys, size_t lo, size_t hi, Node* parent, int level, int redLevel) {
+        if (lo >= hi) return NIL;
+        size_t mid = lo + (hi - lo) / 2;
+        Node* x = new Node(keys[mid], parent, NIL, NIL, level == redLevel ? Node::RED : Node::BLACK);
+        x->left = buildBalanced(keys, lo, mid, x, level + 1, redLevel);
+        x->right = buildBalanced(keys, mid + 1, hi, x, level + 1, redLevel);
+        augment(x);
+        return x;
+    }
+
+    // searchFrom() for a key that can only be at or right of `x`: climbs while the key may lie
+    // beyond the current subtree, i.e. until it is the left subtree of a node above the key.
+    Node* searchNear(Node* x, const Key& key) {
+        while (x->parent != NIL && !(x == x->parent->left && before(key, x->parent->key))) {
+            TREE_STAT(stats.nodesVisited++);
+            x = x->parent;
+        }
+        return searchFrom(x, key);
+    }
+
+    // In-order walk for eraseBatch(): deletes every node that matches the next unused batch key
+    // and appends the others to `survivors`.
+    void detachSurvivors(Node* x, const std::vector<Key>& keys, size_t& next, std::vector<Node*>& survivors,
+                         size_t& removed) {
+        if (x == NIL) return;
+        Node* right = x->right;
+        detachSurvivors(x->left, keys, next, survivors, removed);
+        while (next < keys.size() && before(keys[next], x->key))
+            next++;
+        if (next < keys.size() && !before(x->key, keys[next])) {
+            next++;
+            removed++;
+            delete x;
+        } else {
+            survivors.push_back(x);
+        }
+        detachSurvivors(right, keys, next, survivors, removed);
+    }
+
+    // buildBalanced() over existing nodes.
+    Node* relinkBalanced(std::vector<Node*>& nodes, size_t lo, size_t hi, Node* parent, int level, int redLevel) {
+        if (lo >= hi) return NIL;
+        size_t mid = lo + (hi - lo) / 2;
+        Node* x = nodes[mid];
+        x->parent = parent;
+        x->color = level == redLevel ? Node::RED : Node::BLACK;
+        x->left = relinkBalanced(nodes, lo, mid, x, level + 1, redLevel);
+        x->right = relinkBalanced(nodes, mid + 1, hi, x, level + 1, redLevel);
+        augment(x);
+        return x;
+    }
+
+    void deleteSubtree(Node* x) {
+        if (x != NIL) {
+            deleteSubtree(x->left);
+            deleteSubtree(x->right);
+            delete x;
+        }
+    }
+
+    void RBInsertFixup(Node* z) {
+        while (z->parent->color == Node::RED) {
+            TREE_STAT(stats.insertFixupIterations++);
+            if (z->parent == z->parent->parent->left) {
+                Node* y = z->parent->parent->right;
+                if (y->color == Node::RED) {
+                    z->parent->color = Node::BLACK;
+                    y->color = Node::BLACK;
+                    z->parent->parent->color = Node::RED;
+                    z = z->parent->parent;
+                } else {
+                    if (z == z->parent->right) {
+                        z = z->parent;
+                        leftRotate(z);
+                    }
+                    z->parent->color = Node::BLACK;
+                    z->parent->parent->color = Node::RED;
+                    rightRotate(z->parent->parent);
+                }
+            } else {
+                Node* y = z->parent->parent->left;
+                if (y->color == Node::RED) {
+                    z->parent->color = Node::BLACK;
+                    y->color = Node::BLACK;
+                    z->parent->parent->color = Node::RED;
+                    z = z->parent->parent;
+                } else {
+                    if (z == z->parent->left) {
+                        z = z->parent;
+                        rightRotate(z);
+                    }
+                    z->parent->color = Node::BLACK;
+                    z->parent->parent->color = Node::RED;
+                    leftRotate(z->parent->parent);
+                }
+            }
+        }
+        root->color = Node::BLACK;
+    }
+
+    void RBDeleteFixup(Node* x) {
+        while (x != root && x->color == Node::BLACK) {
+            TREE_STAT(stats.deleteFixupIterations++);
+            if (x == x->parent->left) {
+                Node* w = x->parent->right;
+                if (w->color == Node::RED) {
+                    w->color = Node::BLACK;
+                    x->parent->color = Node::RED;
+                    leftRotate(x->parent);
+                    w = x->parent->right;
+                }
+                if (w->left->color == Node::BLACK && w->right->color == Node::BLACK) {
+                    w->color = Node::RED;
+                    x = x->parent;
+                } else {
+                    if (w->right->color == Node::BLACK) {
+                        w->left->color = Node::BLACK;
+                        w->color = Node::RED;
+                        rightRotate(w);
+                        w = x->parent->right;
+                    }
+                    w->color = x->parent->color;
+                    x->parent->color = Node::BLACK;
+                    w->right->color = Node::BLACK;
+                    leftRotate(x->parent);
+                    x = root;
+                }
+            } else {
+                Node* w = x->parent->left;
+                if (w->color == Node::RED) {
+                    w->color = Node::BLACK;
+                    x->parent->color = Node::RED;
+                    rightRotate(x->parent);
+                    w = x->parent->left;
+                }
+                if (w->right->color == Node::BLACK && w->left->color == Node::BLACK) {
+                    w->color = Node::RED;
+                    x = x->parent;
+                } else {
+                    if (w->left->color == Node::BLACK) {
+                        w->right->color = Node::BLACK;
+                        w->color = Node::RED;
+                        leftRotate(w);
+                        w = x->parent->left;
+                    }
+                    w->color = x->parent->color;
+                    x->parent->color = Node::BLACK;
+                    w->left->color = Node::BLACK;
+                    rightRotate(x->parent);
+                    x = root;
+                }
+            }
+        }
+        x->color = Node::BLACK;
+    }
+
+    void leftRotate(Node* x) {
+        TREE_STAT(stats.rotations++);
+        Node* y = x->right;
+        x->right = y->left;
+        if (y->left != NIL)
+            y->left->parent = x;
+        y->parent = x->parent;
+        if (x->parent == NIL)
+            root = y;
+        else if (x == x->parent->left)
+            x->parent->left = y;
+        else
+            x->parent->right = y;
+        y->left = x;
+        x->parent = y;
+        augment(x);
+        augment(y);
+    }
+
+    void rightRotate(Node* x) {
+        TREE_STAT(stats.rotations++);
+        Node* y = x->left;
+        x->left = y->right;
+        if (y->right != NIL)
+            y->right->parent = x;
+        y->parent = x->parent;
+        if (x->parent == NIL)
+            root = y;
+        else if (x == x->parent->right)
+            x->parent->right = y;
+        else
+            x->parent->left = y;
+        y->right = x;
+        x->parent = y;
+        augment(x);
+        augment(y);
+    }
+
+    // In-order walks, so among equal keys the leftmost node of the colour wins.
+    Node* minimumColored(Node* x, typename Node::Color color) {
+        if (x == NIL) return nullptr;
+        if (Node* left = minimumColored(x->left, color)) return left;
+        if (x->color == color) return x;
+        return minimumColored(x->right, color);
+    }
+
+    Node* maximumColored(Node* x, typename Node::Color color) {
+        if (x == NIL) return nullptr;
+        if (Node* right = maximumColored(x->right, color)) return right;
+        if (x->color == color) return x;
+        return maximumColored(x->left, color);
+    }
+
+    int countRedNodesHelper(Node* node) {
+        if (node == NIL) return 0;
+
+        int count = (node->color == Node::RED) ? 1 : 0;
+        return count + countRedNodesHelper(node->left) + countRedNodesHelper(node->right);
+    }
+
+    int countBlackNodesHelper(Node* node) {
+        if (node == NIL) return 0;
+
+        int count = (node->color == Node::BLACK) ? 1 : 0;
+        return count + countBlackNodesHelper(node->left) + countBlackNodesHelper(node->right);
+    }
+
+    int totalNodesHelper(Node* node) {
+        if (node == NIL) return 0;
+
+        return 1 + totalNodesHelper(node->left) + totalNodesHelper(node->right);
+    }
+};
+
+// The interactive playground and the tools built on it use int keys without payload.
+using RBTree = BasicRBTree<int>;
+using RBNode = RBTree::Node;
+inline RBNode* const NIL = RBTree::NIL;
+
 void rbTreeMenu();
 
 #endif //FINALPROJECTV2_RBTREEOPERATIONS_H
@@ -0,0 +1,152 @@
+
+#ifndef FINALPROJECTV2_SMALLTREE_H
+#define FINALPROJECTV2_SMALLTREE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BTreeOperations.h"
+#include "RBTreeOperations.h"
+
+// Ordered multiset of keys for holding very many small sets, such as one index per tenant. Up to
+// Capacity keys live in a sorted array inside the object, so a small set costs no heap
+// allocation, no nodes and no pointers. The insert that would overflow the array moves the keys
+// into a heap-allocated Tree (a BasicRBTree or BasicBTree). An erase that brings the size down
+// to Capacity / 2 moves them back, so a size hovering around Capacity does not convert back and
+// forth.
+//
+// Keys only; the Tree's key type and comparator are used throughout.
+template <typename Tree, size_t Capacity = 64>
+class SmallTree {
+public:
+    using Key = typename Tree::KeyType;
+    using Compare = typename Tree::CompareType;
+
+    // Minimum degree of a promoted BTree: a few hundred keys fit in a root and a few leaves.
+    static constexpr int PROMOTED_BTREE_DEGREE = 16;
+
+    SmallTree() : tree(nullptr), count(0) {}
+    ~SmallTree() { destroyTree(); }
+    SmallTree(const SmallTree&) = delete;
+    SmallTree& operator=(const SmallTree&) = delete;
+
+    size_t size() const { return count; }
+    bool isInline() const { return tree == nullptr; }
+
+    void insert(const Key& key) {
+        if (tree == nullptr && count == Capacity) promote();
+        if (tree != nullptr) {
+            treeInsert(*tree, key);
+        } else {
+            size_t pos = upperBound(key);
+            std::move_backward(keys.begin() + pos, keys.begin() + count, keys.begin() + count + 1);
+            keys[pos] = key;
+        }
+        count++;
+    }
+
+    // Removes one copy of `key`; false if there is none.
+    bool erase(const Key& key) {
+        if (tree != nullptr) {
+            if (!treeErase(*tree, key)) return false;
+            if (--count <= Capacity / 2) demote();
+            return true;
+        }
+        size_t pos = lowerBound(key);
+        if (pos == count || Compare()(key, keys[pos])) return false;
+        std::move(keys.begin() + pos + 1, keys.begin() + count, keys.begin() + pos);
+        count--;
+        return true;
+    }
+
+    bool contains(const Key& key) {
+        if (tree != nullptr) return treeContains(*tree, key);
+        size_t pos = lowerBound(key);
+        return pos < count && !Compare()(key, keys[pos]);
+    }
+
+    void collectKeys(std::vector<Key>& out) {
+        if (tree != nullptr) {
+            treeCollect(*tree, out);
+        } else {
+            out.insert(out.end(), keys.begin(), keys.begin() + count);
+        }
+    }
+
+private:
+    Tree* tree;         // nullptr while the keys are inline
+    uint32_t count;
+    std::array<Key, Capacity> keys;
+
+    // Index of the first key not ordered before `key`. Branch-free: the number of steps depends
+    // only on count, and each step is a conditional move.
+    size_t lowerBound(const Key& key) const {
+        if (count == 0) return 0;
+        const Key* base = keys.data();
+        for (size_t n = count; n > 1; n -= n / 2) {
+            base = Compare()(base[n / 2 - 1], key) ? base + n / 2 : base;
+        }
+        return (base - keys.data()) + Compare()(*base, key);
+    }
+
+    // Index of the first key ordered after `key`, so equal keys are inserted after their copies.
+    size_t upperBound(const Key& key) const {
+        if (count == 0) return 0;
+        const Key* base = keys.data();
+        for (size_t n = count; n > 1; n -= n / 2) {
+            base = !Compare()(key, base[n / 2 - 1]) ? base + n / 2 : base;
+        }
+        return (base - keys.data()) + !Compare()(key, *base);
+    }
+
+    void promote() {
+        tree = newTree(static_cast<Tree*>(nullptr));
+        for (size_t i = 0; i < count; i++) {
+            treeInsert(*tree, keys[i]);
+        }
+    }
+
+    void demote() {
+        std::vector<Key> sorted;
+        sorted.reserve(count);
+        treeCollect(*tree, sorted);
+        destroyTree();
+        std::move(sorted.begin(), sorted.end(), keys.begin());
+    }
+
+    void destroyTree() {
+        if (tree == nullptr) return;
+        delete tree;
+        tree = nullptr;
+    }
+
+    // The two tree types spell these operations differently.
+    template <typename K, typename V, typename C>
+    static BasicRBTree<K, V, C>* newTree(BasicRBTree<K, V, C>*) { return new BasicRBTree<K, V, C>(); }
+    template <typename K, typename V, typename C>
+    static BasicBTree<K, V, C>* newTree(BasicBTree<K, V, C>*) { return new BasicBTree<K, V, C>(PROMOTED_BTREE_DEGREE); }
+
+    template <typename K, typename V, typename C>
+    static void treeInsert(BasicRBTree<K, V, C>& t, const Key& key) { t.RBInsert(key); }
+    template <typename K, typename V, typename C>
+    static void treeInsert(BasicBTree<K, V, C>& t, const Key& key) { t.insert(key); }
+
+    template <typename K, typename V, typename C>
+    static bool treeErase(BasicRBTree<K, V, C>& t, const Key& key) { return t.erase(key); }
+    template <typename K, typename V, typename C>
+    static bool treeErase(BasicBTree<K, V, C>& t, const Key& key) { return t.deleteKey(key); }
+
+    template <typename K, typename V, typename C>
+    static bool treeContains(BasicRBTree<K, V, C>& t, const Key& key) { return t.search(t.root, key) != t.NIL; }
+    template <typename K, typename V, typename C>
+    static bool treeContains(BasicBTree<K, V, C>& t, const Key& key) { return t.search(key) != nullptr; }
+
+    template <typename K, typename V, typename C>
+    static void treeCollect(BasicRBTree<K, V, C>& t, std::vector<Key>& out) { t.collectKeys(t.root, out); }
+    template <typename K, typename V, typename C>
+    static void treeCollect(BasicBTree<K, V, C>& t, std::vector<Key>& out) { t.collectKeys(out); }
+};
+
+#endif //FINALPROJECTV2_SMALLTREE_H
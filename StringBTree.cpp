@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "StringBTree.h"
+
+using namespace std;
+
+TreeStats StringBTree::stats;
+
+namespace {
+    size_t commonPrefixLength(string_view a, string_view b) {
+        size_t n = min(a.size(), b.size());
+        size_t i = 0;
+        while (i < n && a[i] == b[i]) {
+            i++;
+        }
+        return i;
+    }
+
+    // Orders two suffixes whose heads are equal. Equal heads mean the suffixes agree on their
+    // first min(4, shorter length) bytes, so the compare starts after those.
+    int compareAfterHead(string_view a, string_view b) {
+        size_t skip = min<size_t>(4, min(a.size(), b.size()));
+        return a.substr(skip).compare(b.substr(skip));
+    }
+
+    void deleteNodes(StringBTreeNode* node) {
+        if (node == nullptr) return;
+
+        for (StringBTreeNode* child : node->children) {
+            deleteNodes(child);
+        }
+        delete node;
+    }
+
+    size_t nodeMemory(const StringBTreeNode* node) {
+        size_t bytes = sizeof(StringBTreeNode) + node->slots.capacity() * sizeof(StringBTreeNode::Slot) +
+                       node->bytes.capacity() + node->children.capacity() * sizeof(StringBTreeNode*);
+        if (node->prefix.capacity() > string().capacity()) {
+            bytes += node->prefix.capacity() + 1;
+        }
+        for (const StringBTreeNode* child : node->children) {
+            bytes += nodeMemory(child);
+        }
+        return bytes;
+    }
+
+    void collectKeysInOrder(const StringBTreeNode* node, vector<string>& out) {
+        if (node->isLeaf) {
+            for (size_t i = 0; i < node->size(); i++) {
+                out.push_back(node->key(i));
+            }
+            return;
+        }
+        for (const StringBTreeNode* child : node->children) {
+            collectKeysInOrder(child, out);
+        }
+    }
+}
+
+StringBTreeNode::StringBTreeNode(bool isLeaf) : isLeaf(isLeaf), deadBytes(0) {}
+
+string_view StringBTreeNode::suffix(size_t i) const {
+    return string_view(bytes.data() + slots[i].offset, slots[i].length);
+}
+
+string StringBTreeNode::key(size_t i) const {
+    string_view rest = suffix(i);
+    string result;
+    result.reserve(prefix.size() + rest.size());
+    result.append(prefix).append(rest);
+    return result;
+}
+
+size_t StringBTreeNode::footprint() const {
+    return prefix.size() + slots.size() * sizeof(Slot) + bytes.size() - deadBytes +
+           children.size() * sizeof(StringBTreeNode*);
+}
+
+uint32_t StringBTreeNode::headOf(string_view suffix) {
+    uint32_t head = 0;
+    for (size_t i = 0; i < 4; i++) {
+        head = (head << 8) | (i < suffix.size() ? static_cast<unsigned char>(suffix[i]) : 0);
+    }
+    return head;
+}
+
+size_t StringBTreeNode::rank(string_view key, bool orEqual) const {
+    size_t shared = min(key.size(), prefix.size());
+    int c = memcmp(key.data(), prefix.data(), shared);
+    if (c < 0 || (c == 0 && key.size() < prefix.size())) return 0;
+    if (c > 0) return slots.size();
+
+    string_view rest = key.substr(prefix.size());
+    uint32_t head = headOf(rest);
+    size_t lo = 0, hi = slots.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const Slot& slot = slots[mid];
+        int cmp;
+        TREE_STAT(StringBTree::stats.comparisons++);
+        if (slot.head != head) {
+            cmp = slot.head < head ? -1 : 1;
+        } else {
+            TREE_STAT(StringBTree::stats.keyByteComparisons++);
+            cmp = compareAfterHead(suffix(mid), rest);
+        }
+        if (cmp < 0 || (orEqual && cmp == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool StringBTreeNode::equals(size_t i, string_view key) const {
+    return key.size() == prefix.size() + slots[i].length && key.compare(0, prefix.size(), prefix) == 0 &&
+           key.substr(prefix.size()) == suffix(i);
+}
+
+void StringBTreeNode::insertAt(size_t i, string_view key) {
+    if (key.size() < prefix.size() || key.compare(0, prefix.size(), prefix) != 0) {
+        // The new key does not share the node's prefix: re-encode under a shorter one.
+        vector<string> keys;
+        keys.reserve(slots.size() + 1);
+        for (size_t j = 0; j < slots.size(); j++) {
+            keys.push_back(this->key(j));
+        }
+        keys.insert(keys.begin() + i, string(key));
+        assign(keys);
+        return;
+    }
+    string_view rest = key.substr(prefix.size());
+    Slot slot = {headOf(rest), static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(rest.size())};
+    bytes.insert(bytes.end(), rest.begin(), rest.end());
+    slots.insert(slots.begin() + i, slot);
+}
+
+void StringBTreeNode::removeAt(size_t i) {
+    deadBytes += slots[i].length;
+    slots.erase(slots.begin() + i);
+    if (deadBytes * 2 <= bytes.size()) return;
+
+    vector<char> live;
+    live.reserve(bytes.size() - deadBytes);
+    for (Slot& slot : slots) {
+        uint32_t offset = static_cast<uint32_t>(live.size());
+        live.insert(live.end(), bytes.begin() + slot.offset, bytes.begin() + slot.offset + slot.length);
+        slot.offset = offset;
+    }
+    bytes.swap(live);
+    deadBytes = 0;
+}
+
+void StringBTreeNode::assign(const vector<string>& keys) {
+    prefix = keys.empty() ? string() : keys.front().substr(0, commonPrefixLength(keys.front(), keys.back()));
+    slots.clear();
+    bytes.clear();
+    deadBytes = 0;
+    slots.reserve(keys.size());
+    for (const string& key : keys) {
+        string_view rest = string_view(key).substr(prefix.size());
+        slots.push_back({headOf(rest), static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(rest.size())});
+        bytes.insert(bytes.end(), rest.begin(), rest.end());
+    }
+}
+
+StringBTree::StringBTree(size_t nodeBytes) : root(nullptr), nodeBytes(nodeBytes), count(0) {}
+
+StringBTree::~StringBTree() {
+    clear();
+}
+
+const StringBTreeNode* StringBTree::findLeaf(string_view key) const {
+    const StringBTreeNode* node = root;
+    while (!node->isLeaf) {
+        TREE_STAT(stats.nodesVisited++);
+        node = node->children[node->rank(key, true)];
+    }
+    TREE_STAT(stats.nodesVisited++);
+    return node;
+}
+
+bool StringBTree::contains(string_view key) const {
+    TREE_STAT(stats.searches++);
+    if (root == nullptr) return false;
+    const StringBTreeNode* leaf = findLeaf(key);
+    size_t pos = leaf->rank(key, false);
+    return pos < leaf->size() && leaf->equals(pos, key);
+}
+
+bool StringBTree::insert(string_view key) {
+    if (root == nullptr) {
+        root = new StringBTreeNode(true);
+    }
+    string separator;
+    StringBTreeNode* right = nullptr;
+    if (!insertInto(root, key, separator, right)) return false;
+
+    if (right != nullptr) {
+        StringBTreeNode* top = new StringBTreeNode(false);
+        top->assign({separator});
+        top->children = {root, right};
+        root = top;
+    }
+    count++;
+    return true;
+}
+
+bool StringBTree::insertInto(StringBTreeNode* node, string_view key, string& separator, StringBTreeNode*& right) {
+    if (node->isLeaf) {
+        size_t pos = node->rank(key, false);
+        if (pos < node->size() && node->equals(pos, key)) return false;
+        node->insertAt(pos, key);
+    } else {
+        size_t i = node->rank(key, true);
+        string childSeparator;
+        StringBTreeNode* childRight = nullptr;
+        if (!insertInto(node->children[i], key, childSeparator, childRight)) return false;
+        if (childRight == nullptr) return true;
+        node->insertAt(i, childSeparator);
+        node->children.insert(node->children.begin() + i + 1, childRight);
+    }
+
+    if (node->footprint() > nodeBytes && node->size() >= (node->isLeaf ? 2u : 3u)) {
+        split(node, separator, right);
+    }
+    return true;
+}
+
+// Leaves split in half and pass up the shortest key that is above everything on the left and
+// not above the first key on the right. Internal nodes move their middle separator up. Both
+// halves are re-encoded, which usually lengthens their shared prefix.
+void StringBTree::split(StringBTreeNode* node, string& separator, StringBTreeNode*& right) {
+    TREE_STAT(stats.splits++);
+    vector<string> keys;
+    keys.reserve(node->size());
+    for (size_t i = 0; i < node->size(); i++) {
+        keys.push_back(node->key(i));
+    }
+    size_t mid = keys.size() / 2;
+
+    right = new StringBTreeNode(node->isLeaf);
+    if (node->isLeaf) {
+        separator = keys[mid].substr(0, commonPrefixLength(keys[mid - 1], keys[mid]) + 1);
+        right->assign(vector<string>(keys.begin() + mid, keys.end()));
+    } else {
+        separator = keys[mid];
+        right->assign(vector<string>(keys.begin() + mid + 1, keys.end()));
+        right->children.assign(node->children.begin() + mid + 1, node->children.end());
+        node->children.resize(mid + 1);
+    }
+    keys.resize(mid);
+    node->assign(keys);
+}
+
+bool StringBTree::erase(string_view key) {
+    if (root == nullptr) return false;
+    StringBTreeNode* leaf = const_cast<StringBTreeNode*>(findLeaf(key));
+    size_t pos = leaf->rank(key, false);
+    if (pos >= leaf->size() || !leaf->equals(pos, key)) return false;
+    leaf->removeAt(pos);
+    count--;
+    return true;
+}
+
+int StringBTree::depth() const {
+    int levels = 0;
+    for (const StringBTreeNode* node = root; node != nullptr; node = node->isLeaf ? nullptr : node->children[0]) {
+        levels++;
+    }
+    return levels;
+}
+
+size_t StringBTree::memoryUsage() const {
+    return root == nullptr ? 0 : nodeMemory(root);
+}
+
+void StringBTree::collectKeys(vector<string>& out) const {
+    out.reserve(out.size() + count);
+    if (root != nullptr) collectKeysInOrder(root, out);
+}
+
+void StringBTree::traverse() const {
+    vector<string> keys;
+    collectKeys(keys);
+    for (const string& key : keys) {
+        cout << " " << key;
+    }
+}
+
+void StringBTree::clear() {
+    deleteNodes(root);
+    root = nullptr;
+    count = 0;
+}
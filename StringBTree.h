@@ -0,0 +1,88 @@
+
+#ifndef FINALPROJECTV2_STRINGBTREE_H
+#define FINALPROJECTV2_STRINGBTREE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TreeStats.h"
+
+// Node of a StringBTree. The keys of a node share `prefix`, which is stored once; each slot
+// points at the rest of its key (the suffix) in the node's `bytes` buffer and caches the first
+// four suffix bytes as a big-endian integer (`head`). Two keys whose heads differ compare like
+// their heads, so most comparisons in a search are one integer compare and never touch `bytes`.
+struct StringBTreeNode {
+    struct Slot {
+        uint32_t head;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    bool isLeaf;
+    std::string prefix;
+    std::vector<Slot> slots;                    // in key order
+    std::vector<char> bytes;                    // suffixes, in insertion order
+    std::vector<StringBTreeNode*> children;     // internal nodes: slots.size() + 1
+    size_t deadBytes;                           // bytes of erased suffixes still in `bytes`
+
+    explicit StringBTreeNode(bool isLeaf);
+
+    size_t size() const { return slots.size(); }
+    std::string_view suffix(size_t i) const;
+    std::string key(size_t i) const;
+    size_t footprint() const;
+
+    // Number of keys ordered before `key`, counting keys equal to it too when `orEqual`.
+    size_t rank(std::string_view key, bool orEqual) const;
+    bool equals(size_t i, std::string_view key) const;
+
+    void insertAt(size_t i, std::string_view key);
+    void removeAt(size_t i);
+    // Replaces the contents with `keys` (sorted) under their longest common prefix.
+    void assign(const std::vector<std::string>& keys);
+
+    static uint32_t headOf(std::string_view suffix);
+};
+
+// B+-Tree over byte-string keys (URLs, paths) that keeps each node's keys in one buffer
+// instead of a std::string per key. Leaves hold the keys; internal nodes hold the shortest
+// separators that route between their children (suffix truncation), and every node strips the
+// prefix its keys share (prefix truncation). A node is split when its slots, key bytes and
+// child pointers outgrow `nodeBytes`.
+//
+// Keys are unique. erase() does not merge underfull nodes: a node emptied by erases stays
+// in the tree until clear(), which suits the load-mostly indexes this is meant for.
+struct StringBTree {
+    static TreeStats stats;
+
+    StringBTreeNode* root;
+    size_t nodeBytes;
+
+    explicit StringBTree(size_t nodeBytes = 4096);
+    ~StringBTree();
+
+    StringBTree(const StringBTree&) = delete;
+    StringBTree& operator=(const StringBTree&) = delete;
+
+    bool insert(std::string_view key);      // false if the key was already present
+    bool contains(std::string_view key) const;
+    bool erase(std::string_view key);       // false if the key was not present
+
+    size_t keyCount() const { return count; }
+    int depth() const;
+    size_t memoryUsage() const;             // bytes held by nodes, including spare capacity
+    void collectKeys(std::vector<std::string>& out) const;
+    void traverse() const;
+    void clear();
+
+private:
+    size_t count;
+
+    const StringBTreeNode* findLeaf(std::string_view key) const;
+    bool insertInto(StringBTreeNode* node, std::string_view key, std::string& separator,
+                    StringBTreeNode*& right);
+    void split(StringBTreeNode* node, std::string& separator, StringBTreeNode*& right);
+};
+
+#endif //FINALPROJECTV2_STRINGBTREE_H
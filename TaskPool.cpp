@@ -0,0 +1,122 @@
+#include <algorithm>
+#include "TaskPool.h"
+
+using namespace std;
+
+thread_local size_t TaskPool::currentSlot = 0;
+
+TaskPool::TaskPool(unsigned threads) : queued(0), stopping(false) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        queues.push_back(make_unique<Queue>());
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        workers.emplace_back(&TaskPool::workerLoop, this, i);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void TaskPool::run(const function<void()>& task) {
+    lock_guard<mutex> guard(runLock);
+    struct RestoreSlot {
+        size_t outerSlot;
+        ~RestoreSlot() { currentSlot = outerSlot; }
+    } restore{currentSlot};
+    currentSlot = 0;
+    task();
+}
+
+void TaskPool::spawn(Group& group, function<void()> task) {
+    group.pending.fetch_add(1, memory_order_relaxed);
+    Queue& own = *queues[currentSlot];
+    {
+        lock_guard<mutex> guard(own.lock);
+        own.tasks.push_back({move(task), &group});
+        own.count.store(own.tasks.size(), memory_order_relaxed);
+    }
+    queued.fetch_add(1);
+    // Taking the lock orders this wake-up after any sleeper's check of `queued`.
+    { lock_guard<mutex> guard(sleepLock); }
+    wake.notify_one();
+}
+
+void TaskPool::wait(Group& group) {
+    Task task;
+    while (group.pending.load(memory_order_acquire) > 0) {
+        if (popOwn(currentSlot, task) || steal(currentSlot, task)) {
+            execute(task);
+        } else {
+            this_thread::yield();
+        }
+    }
+    // The tasks that stored the error released it with their decrement of `pending`.
+    if (group.error) {
+        exception_ptr error = move(group.error);
+        group.error = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+bool TaskPool::popOwn(size_t self, Task& task) {
+    Queue& own = *queues[self];
+    lock_guard<mutex> guard(own.lock);
+    if (own.tasks.empty()) return false;
+    task = move(own.tasks.back());
+    own.tasks.pop_back();
+    own.count.store(own.tasks.size(), memory_order_relaxed);
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool TaskPool::steal(size_t self, Task& task) {
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& victim = *queues[(self + i) % queues.size()];
+        if (victim.count.load(memory_order_relaxed) == 0) continue;
+        lock_guard<mutex> guard(victim.lock);
+        if (victim.tasks.empty()) continue;
+        task = move(victim.tasks.front());
+        victim.tasks.pop_front();
+        victim.count.store(victim.tasks.size(), memory_order_relaxed);
+        queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+void TaskPool::execute(Task& task) {
+    Group* group = task.group;
+    try {
+        task.run();
+    } catch (...) {
+        lock_guard<mutex> guard(group->errorLock);
+        if (!group->error) group->error = current_exception();
+    }
+    task.run = nullptr;
+    group->pending.fetch_sub(1, memory_order_release);
+}
+
+void TaskPool::workerLoop(size_t self) {
+    currentSlot = self;
+    Task task;
+    while (true) {
+        if (popOwn(self, task) || steal(self, task)) {
+            execute(task);
+            continue;
+        }
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+        if (stopping) return;
+    }
+}
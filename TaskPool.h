@@ -0,0 +1,88 @@
+
+#ifndef FINALPROJECTV2_TASKPOOL_H
+#define FINALPROJECTV2_TASKPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fork-join thread pool with work stealing. Every participant owns a deque. spawn() pushes onto
+// the caller's deque, and the owner pops from that same end, so it keeps working depth-first on
+// what it spawned last. Idle participants steal from the other end, which holds the oldest and
+// usually largest tasks. wait() does not block while its group is pending: it runs the caller's
+// own tasks and steals others.
+//
+// run() makes the calling thread participant 0 for the duration of one root task, and only one
+// run() executes at a time. spawn(), wait() and wantsTasks() may only be called from inside it.
+// An exception thrown by a task is kept in its group and rethrown by wait() once every task of
+// the group has finished; if several tasks throw, the first one caught wins.
+class TaskPool {
+public:
+    // The tasks one wait() waits for.
+    class Group {
+    public:
+        Group() : pending(0) {}
+
+    private:
+        friend class TaskPool;
+        std::atomic<size_t> pending;
+        std::mutex errorLock;
+        std::exception_ptr error;
+    };
+
+    // `threads` counts the participants including run()'s caller; 0 means one per hardware thread.
+    explicit TaskPool(unsigned threads = 0);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    void run(const std::function<void()>& task);
+    void spawn(Group& group, std::function<void()> task);
+    void wait(Group& group);
+
+    // Whether splitting off a task now would feed someone: there are other participants and the
+    // caller has nothing queued for them to steal.
+    bool wantsTasks() const {
+        return queues.size() > 1 && queues[currentSlot]->count.load(std::memory_order_relaxed) == 0;
+    }
+
+private:
+    struct Task {
+        std::function<void()> run;
+        Group* group;
+    };
+
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+        std::atomic<size_t> count{0};
+    };
+
+    // The calling thread's participant slot in the pool it is working for.
+    static thread_local size_t currentSlot;
+
+    std::vector<std::unique_ptr<Queue>> queues;     // queues[0] belongs to run()'s caller
+    std::vector<std::thread> workers;
+    std::mutex runLock;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<size_t> queued;                     // tasks in all deques
+    std::atomic<bool> stopping;
+
+    bool popOwn(size_t self, Task& task);
+    bool steal(size_t self, Task& task);
+    void execute(Task& task);
+    void workerLoop(size_t self);
+};
+
+#endif //FINALPROJECTV2_TASKPOOL_H
@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include "Checksum.h"
+#include "TreeSnapshot.h"
+
+using namespace std;
+
+namespace TreeSnapshot {
+    namespace {
+        const char MAGIC[4] = {'A', 'D', 'S', 'S'};
+        const uint8_t VERSION = 1;
+        const size_t HEADER_SIZE = 32;
+
+        void putU64(unsigned char* p, uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                p[i] = static_cast<unsigned char>(value >> (8 * i));
+            }
+        }
+
+        uint64_t getU64(const unsigned char* p) {
+            uint64_t value = 0;
+            for (int i = 7; i >= 0; --i) {
+                value = (value << 8) | p[i];
+            }
+            return value;
+        }
+
+        void putVarint(vector<unsigned char>& out, uint32_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<unsigned char>(value));
+        }
+
+        bool getVarint(const unsigned char*& p, const unsigned char* end, uint32_t& value) {
+            if (p < end && *p < 0x80) {
+                value = *p++;
+                return true;
+            }
+            value = 0;
+            for (int shift = 0; shift < 35 && p < end; shift += 7) {
+                unsigned char byte = *p++;
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (byte < 0x80) return true;
+            }
+            return false;
+        }
+    }
+
+    void encode(Kind kind, const vector<int>& sortedKeys, uint64_t sequence, vector<unsigned char>& out) {
+        out.assign(HEADER_SIZE, 0);
+        out.reserve(HEADER_SIZE + sortedKeys.size() + sortedKeys.size() / 2 + 4);
+        memcpy(out.data(), MAGIC, 4);
+        out[4] = VERSION;
+        out[5] = kind;
+        putU64(out.data() + 8, sortedKeys.size());
+        putU64(out.data() + 16, sequence);
+
+        uint32_t previous = 0;
+        for (size_t i = 0; i < sortedKeys.size(); ++i) {
+            uint32_t key = static_cast<uint32_t>(sortedKeys[i]);
+            if (i == 0) {
+                putVarint(out, (key << 1) ^ static_cast<uint32_t>(sortedKeys[i] >> 31));
+            } else {
+                putVarint(out, key - previous);
+            }
+            previous = key;
+        }
+        putU64(out.data() + 24, out.size() - HEADER_SIZE);
+
+        uint32_t crc = Checksum::crc32(out.data(), out.size());
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<unsigned char>(crc >> (8 * i)));
+        }
+    }
+
+    bool decode(const vector<unsigned char>& image, Kind kind, vector<int>& sortedKeys, uint64_t& sequence) {
+        if (image.size() < HEADER_SIZE + 4 || memcmp(image.data(), MAGIC, 4) != 0 ||
+            image[4] != VERSION || image[5] != kind) {
+            return false;
+        }
+        size_t body = image.size() - 4;
+        uint32_t storedCrc = 0;
+        for (int i = 3; i >= 0; --i) {
+            storedCrc = (storedCrc << 8) | image[body + i];
+        }
+        uint64_t count = getU64(image.data() + 8);
+        uint64_t payloadSize = getU64(image.data() + 24);
+        if (payloadSize != body - HEADER_SIZE || count > payloadSize ||
+            Checksum::crc32(image.data(), body) != storedCrc) {
+            return false;
+        }
+
+        const unsigned char* p = image.data() + HEADER_SIZE;
+        const unsigned char* end = image.data() + body;
+        sortedKeys.resize(count);
+        uint32_t key = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint32_t value;
+            if (!getVarint(p, end, value)) return false;
+            key = (i == 0) ? ((value >> 1) ^ (0u - (value & 1))) : key + value;
+            sortedKeys[i] = static_cast<int>(key);
+        }
+        sequence = getU64(image.data() + 16);
+        return p == end;
+    }
+
+    bool write(const string& path, Kind kind, const vector<int>& sortedKeys) {
+        vector<unsigned char> image;
+        encode(kind, sortedKeys, 0, image);
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr) return false;
+        bool ok = fwrite(image.data(), 1, image.size(), file) == image.size();
+        return fclose(file) == 0 && ok;
+    }
+
+    bool read(const string& path, Kind kind, vector<int>& sortedKeys) {
+        vector<unsigned char> image;
+        uint64_t sequence;
+        return readFile(path, image) && decode(image, kind, sortedKeys, sequence);
+    }
+
+    bool readFile(const string& path, vector<unsigned char>& out) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) return false;
+
+        error_code ec;
+        uintmax_t size = filesystem::file_size(path, ec);
+        out.resize(ec ? 0 : static_cast<size_t>(size));
+        size_t read = fread(out.data(), 1, out.size(), file);
+        out.resize(read);
+        fclose(file);
+        return true;
+    }
+}
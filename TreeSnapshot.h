@@ -0,0 +1,31 @@
+
+#ifndef FINALPROJECTV2_TREESNAPSHOT_H
+#define FINALPROJECTV2_TREESNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary snapshot of a tree's keys in sorted order.
+//
+// Layout (little-endian): magic "ADSS" | version (1) | kind (1) | reserved (2) |
+// key count (8) | sequence (8) | payload size (8) | payload | crc32 of all preceding bytes (4).
+// The payload is the first key zigzag-encoded, then the gap to each following key, all as
+// LEB128 varints, so dense key sets cost about one byte per key.
+namespace TreeSnapshot {
+    enum Kind : uint8_t {
+        BST = 1,
+        RED_BLACK = 2,
+        BTREE = 3
+    };
+
+    // `sequence` is opaque to the snapshot; the write-ahead log stores its checkpoint LSN there.
+    void encode(Kind kind, const std::vector<int>& sortedKeys, uint64_t sequence, std::vector<unsigned char>& out);
+    bool decode(const std::vector<unsigned char>& image, Kind kind, std::vector<int>& sortedKeys, uint64_t& sequence);
+
+    bool write(const std::string& path, Kind kind, const std::vector<int>& sortedKeys);
+    bool read(const std::string& path, Kind kind, std::vector<int>& sortedKeys);
+    bool readFile(const std::string& path, std::vector<unsigned char>& out);
+}
+
+#endif //FINALPROJECTV2_TREESNAPSHOT_H
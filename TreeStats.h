@@ -0,0 +1,72 @@
+
+#ifndef FINALPROJECTV2_TREESTATS_H
+#define FINALPROJECTV2_TREESTATS_H
+
+#include <cstdint>
+#include <iostream>
+
+// Structural event counters. Each tree type owns one TreeStats (BSTree::stats, RBTree::stats,
+// BTree::stats, StringBTree::stats, ...) that its operations bump through TREE_STAT. Unless the build defines
+// ADS_TREE_STATS the macro discards its argument, so the counting code is not even compiled.
+#ifdef ADS_TREE_STATS
+#define TREE_STATS_ENABLED 1
+#define TREE_STAT(statement) statement
+#else
+#define TREE_STATS_ENABLED 0
+#define TREE_STAT(statement)
+#endif
+
+struct TreeStats {
+    uint64_t searches = 0;
+    uint64_t comparisons = 0;           // key comparisons made by searches
+    uint64_t nodesVisited = 0;          // nodes touched by searches
+    uint64_t rotations = 0;
+    uint64_t insertFixupIterations = 0;
+    uint64_t deleteFixupIterations = 0;
+    uint64_t splits = 0;
+    uint64_t merges = 0;
+    uint64_t borrowsFromPrev = 0;
+    uint64_t borrowsFromNext = 0;
+    uint64_t successorWalks = 0;
+    uint64_t successorSteps = 0;        // pointers followed by successor walks
+    uint64_t keyByteComparisons = 0;    // StringBTree comparisons not settled by the cached key head
+    uint64_t duplicates = 0;            // BSTree inserts that raised an existing node's count
+    uint64_t bufferFlushes = 0;         // BEpsilonTree batches moved from a buffer to a child
+    uint64_t messagesFlushed = 0;       // messages carried by those batches
+
+    void reset() { *this = TreeStats(); }
+
+    void print(std::ostream& out) const {
+        if (!TREE_STATS_ENABLED) {
+            out << "Operation counters are disabled in this build (compile with -DADS_TREE_STATS).\n";
+            return;
+        }
+        out << "Searches: " << searches << "\n";
+        out << "Comparisons: " << comparisons << "\n";
+        out << "Nodes visited: " << nodesVisited << "\n";
+        if (searches > 0) {
+            out << "Per search: " << static_cast<double>(comparisons) / searches << " comparisons, "
+                << static_cast<double>(nodesVisited) / searches << " nodes\n";
+        }
+        printIfNonZero(out, "Rotations", rotations);
+        printIfNonZero(out, "Insert fixup iterations", insertFixupIterations);
+        printIfNonZero(out, "Delete fixup iterations", deleteFixupIterations);
+        printIfNonZero(out, "Splits", splits);
+        printIfNonZero(out, "Merges", merges);
+        printIfNonZero(out, "Borrows from previous sibling", borrowsFromPrev);
+        printIfNonZero(out, "Borrows from next sibling", borrowsFromNext);
+        printIfNonZero(out, "Successor walks", successorWalks);
+        printIfNonZero(out, "Successor walk steps", successorSteps);
+        printIfNonZero(out, "Comparisons reading key bytes", keyByteComparisons);
+        printIfNonZero(out, "Duplicate inserts", duplicates);
+        printIfNonZero(out, "Buffer flushes", bufferFlushes);
+        printIfNonZero(out, "Messages flushed", messagesFlushed);
+    }
+
+private:
+    static void printIfNonZero(std::ostream& out, const char* label, uint64_t value) {
+        if (value != 0) out << label << ": " << value << "\n";
+    }
+};
+
+#endif //FINALPROJECTV2_TREESTATS_H
@@ -0,0 +1,31 @@
+
+#ifndef FINALPROJECTV2_TREETRAITS_H
+#define FINALPROJECTV2_TREETRAITS_H
+
+#include <type_traits>
+
+// Shared pieces of the BasicBSTree / BasicRBTree / BasicBTree templates.
+//
+// Key      any type ordered by Compare; copied when it moves between B-Tree nodes.
+// Value    payload stored next to the key in the node, moved in on insert; NoValue (the default,
+//          used by the int playground trees) stores nothing.
+// Compare  a stateless function object. It is default-constructed at every comparison so the
+//          comparison inlines into the search loops. With a transparent comparator (one that
+//          declares is_transparent, like std::less<>) the lookup functions accept any type the
+//          comparator can order against Key, without converting it to Key first.
+//
+// Keys that compare equivalent (neither orders before the other) are equal; the trees keep
+// duplicates, and lookups return one of them. BasicBSTree keeps them as a count on one node.
+//
+// BasicRBTree takes a fourth parameter, Augment, for trees whose nodes cache something about
+// their subtree (IntervalTree.h). Augment()(x, NIL) must recompute x's cache from x's own entry
+// and its children's caches; the tree calls it bottom-up wherever a subtree changes shape.
+// NoAugment, the default, caches nothing and costs nothing.
+struct NoValue {};
+
+struct NoAugment {};
+
+template <typename Value>
+struct StoresValues : std::integral_constant<bool, !std::is_same<Value, NoValue>::value> {};
+
+#endif //FINALPROJECTV2_TREETRAITS_H
@@ -0,0 +1,140 @@
+
+#ifndef FINALPROJECTV2_PERFCOUNTERS_H
+#define FINALPROJECTV2_PERFCOUNTERS_H
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the calling thread through perf_event_open (Linux only).
+// Each event is opened on its own, user space only, so an event the CPU, hypervisor or
+// perf_event_paranoid setting does not allow just reads as unavailable instead of disabling the
+// rest. When the kernel multiplexes the counters, values are scaled by enabled/running time.
+// On other systems every event is unavailable.
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        EVENT_COUNT
+    };
+
+    struct Reading {
+        double values[EVENT_COUNT] = {};
+        bool valid[EVENT_COUNT] = {};
+    };
+
+    PerfCounters() {
+        for (int event = 0; event < EVENT_COUNT; ++event) {
+            fds[event] = open(static_cast<Event>(event));
+        }
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* name(Event event) {
+        static const char* const NAMES[EVENT_COUNT] = {"cycles", "instructions", "l1d_misses", "llc_misses",
+                                                       "branch_misses"};
+        return NAMES[event];
+    }
+
+    bool available(Event event) const { return fds[event] >= 0; }
+
+    bool anyAvailable() const {
+        for (int fd : fds) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    // Zeroes and starts every available counter.
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops the counters and returns what they counted since start().
+    Reading stop() {
+        Reading reading;
+#ifdef __linux__
+        for (int fd : fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int event = 0; event < EVENT_COUNT; ++event) {
+            uint64_t data[3];   // value, time enabled, time running
+            if (fds[event] < 0 || ::read(fds[event], data, sizeof(data)) != sizeof(data) || data[2] == 0) continue;
+            reading.values[event] = static_cast<double>(data[0]) * data[1] / data[2];
+            reading.valid[event] = true;
+        }
+#endif
+        return reading;
+    }
+
+private:
+    int fds[EVENT_COUNT];
+
+    static int open(Event event) {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        switch (event) {
+            case CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case LLC_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            default:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+        }
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void) event;
+        return -1;
+#endif
+    }
+};
+
+#endif //FINALPROJECTV2_PERFCOUNTERS_H
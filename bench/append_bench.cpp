@@ -0,0 +1,88 @@
+// Sequential ingest into BTree: insert throughput and how full the nodes end up.
+//
+// usage: append_bench [keys=10000000] [probes=1000000] [seed=1]
+//
+// Keys are timestamps: strictly increasing, 1-10 apart. Each minimum degree is loaded three
+// ways: by inserting the timestamps in order (the append path), by inserting them in random
+// order, and with buildFromSorted. fill is keys / (nodes * (2t - 1)); lookups probe present keys
+// in random order. Prints one CSV row per tree.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../BTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+size_t countNodes(const BTreeNode* node) {
+    if (node == nullptr) return 0;
+    size_t nodes = 1;
+    for (const BTreeNode* child : node->children) {
+        nodes += countNodes(child);
+    }
+    return nodes;
+}
+
+void row(int t, const char* load, BTree& tree, size_t keys, double insertNs, const vector<int>& probes) {
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : probes) {
+        found += tree.search(key) != nullptr;
+    }
+    double searchNs = nsPerOp(start, probes.size());
+    resultSink = found;
+    if (found != probes.size()) {
+        cerr << found << " of " << probes.size() << " probes found\n";
+        exit(1);
+    }
+    size_t nodes = countNodes(tree.root);
+    cout << t << "," << load << "," << keys << ",";
+    if (insertNs > 0) cout << insertNs;
+    cout << "," << nodes << "," << static_cast<double>(keys) / (nodes * (2 * t - 1)) << "," << tree.depth() << ","
+         << searchNs << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    vector<int> keys(count);
+    int timestamp = 0;
+    for (int& key : keys) {
+        timestamp += 1 + static_cast<int>(rng() % 10);
+        key = timestamp;
+    }
+    vector<int> shuffled = keys;
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+    vector<int> probes(probeCount);
+    for (int& key : probes) {
+        key = keys[rng() % count];
+    }
+
+    cout << "t,load,keys,insert_ns,nodes,fill,depth,search_ns\n";
+    for (int t : {8, 32, 64, 128}) {
+        for (const vector<int>* order : {&keys, &shuffled}) {
+            BTree tree(t);
+            auto start = chrono::steady_clock::now();
+            for (int key : *order) {
+                tree.insert(key);
+            }
+            double insertNs = nsPerOp(start, count);
+            row(t, order == &keys ? "sequential" : "random", tree, count, insertNs, probes);
+        }
+        BTree tree(t);
+        tree.buildFromSorted(keys);
+        row(t, "bulk", tree, count, 0, probes);
+    }
+    return 0;
+}
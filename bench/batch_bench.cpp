@@ -0,0 +1,85 @@
+// Batched B-Tree lookups: BTree::searchBatch() against one search() call per key.
+//
+// usage: batch_bench [sizes=100000,1000000,20000000] [probes=4000000] [t=32] [seed=1]
+//
+// For each size, n distinct even keys are bulk-loaded into a BTree of minimum degree t and
+// probed with the same keys, half present and half absent odd keys, in random order. The batched
+// rows hand the probes to searchBatch() in chunks of `batch` keys, as a request path resolving
+// that many keys at a time would. Prints millions of lookups per second and the speedup over the
+// single-key loop (CSV); every batch result is checked against search().
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {100000, 1000000, 20000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 4000000;
+    int t = argc > 3 ? atoi(argv[3]) : 32;
+    mt19937_64 rng(argc > 4 ? strtoull(argv[4], nullptr, 10) : 1);
+
+    cout << "keys,method,batch,mlookups_per_s,speedup\n";
+    for (size_t n : sizes) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = static_cast<int>(2 * i);
+        }
+        BTree tree(t);
+        tree.buildFromSorted(keys);
+        keys.clear();
+        keys.shrink_to_fit();
+
+        vector<int> probes(probeCount);
+        for (int& key : probes) {
+            key = static_cast<int>(rng() % (2 * n));
+        }
+
+        vector<BTreeNode*> expected(probes.size());
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < probes.size(); i++) {
+            expected[i] = tree.search(probes[i]);
+        }
+        double single = probes.size() / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+        cout << n << ",search,1," << single << ",1\n";
+
+        for (size_t batch : {16, 64, 256, 4096}) {
+            vector<int> chunk;
+            vector<BTreeNode*> results;
+            size_t found = 0;
+            start = chrono::steady_clock::now();
+            for (size_t first = 0; first < probes.size(); first += batch) {
+                chunk.assign(probes.begin() + first, probes.begin() + min(first + batch, probes.size()));
+                tree.searchBatch(chunk, results);
+                for (size_t i = 0; i < results.size(); i++) {
+                    found += results[i] != nullptr;
+                    if (results[i] != expected[first + i]) {
+                        cerr << "searchBatch disagrees with search for key " << chunk[i] << "\n";
+                        return 1;
+                    }
+                }
+            }
+            double rate = probes.size() / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+            resultSink = found;
+            cout << n << ",searchBatch," << batch << "," << rate << "," << rate / single << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Insert-heavy ingest: BEpsilonTree against BTree on write throughput and lookup latency.
+//
+// usage: bepsilon_bench [ops=10000000] [probes=1000000] [seed=1]
+//
+// The stream is 95% inserts of distinct even keys in random order and 5% deletes of keys drawn
+// from those inserted so far. Every tree ingests the same stream, then answers the same probes:
+// surviving keys and odd (absent) keys, in random order. BEpsilonTree runs with 256-key leaves and
+// several fanout/buffer shapes; its lookups are timed twice, with the messages still buffered and
+// after flush(). Prints ingest ns/op and lookup ns (CSV).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../BEpsilonTree.h"
+#include "../BTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+struct Op {
+    int key;
+    bool erase;
+};
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+template <typename Contains>
+void probe(const vector<int>& hits, const vector<int>& misses, Contains contains, double& hitNs, double& missNs) {
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : hits) {
+        found += contains(key);
+    }
+    hitNs = nsPerOp(start, hits.size());
+    start = chrono::steady_clock::now();
+    for (int key : misses) {
+        found += contains(key);
+    }
+    missNs = nsPerOp(start, misses.size());
+    resultSink = found;
+    if (found != hits.size()) {
+        cerr << found << " of " << hits.size() << " lookups found, expected exactly the hits\n";
+        exit(1);
+    }
+}
+
+void row(const string& tree, const char* state, size_t ops, double ingestNs, double hitNs, double missNs,
+         int depth, size_t pending) {
+    cout << tree << "," << state << "," << ops << ",";
+    if (ingestNs > 0) cout << ingestNs;
+    cout << "," << hitNs << "," << missNs << "," << depth << "," << pending << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t opCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    vector<int> inserted;
+    vector<bool> deleted;
+    vector<Op> ops;
+    ops.reserve(opCount);
+    for (size_t i = 0; i < opCount; i++) {
+        if (!inserted.empty() && rng() % 100 < 5) {
+            size_t victim = rng() % inserted.size();
+            deleted[victim] = true;
+            ops.push_back({inserted[victim], true});
+        } else {
+            inserted.push_back(static_cast<int>(2 * inserted.size()));
+            deleted.push_back(false);
+            ops.push_back({inserted.back(), false});
+        }
+    }
+    // Keys are handed out in order above; shuffle the values, not the stream positions.
+    vector<int> permutation(inserted.size());
+    for (size_t i = 0; i < permutation.size(); i++) {
+        permutation[i] = static_cast<int>(2 * i);
+    }
+    shuffle(permutation.begin(), permutation.end(), rng);
+    for (Op& op : ops) {
+        op.key = permutation[op.key / 2];
+    }
+
+    vector<int> hits, misses;
+    while (hits.size() < probeCount) {
+        size_t i = rng() % inserted.size();
+        if (!deleted[i]) hits.push_back(permutation[i]);
+    }
+    while (misses.size() < probeCount) {
+        misses.push_back(static_cast<int>(rng() % (2 * inserted.size())) | 1);
+    }
+
+    cout << "tree,state,ops,ingest_ns,hit_ns,miss_ns,depth,pending_messages\n";
+    double hitNs, missNs;
+
+    for (int t : {32, 64}) {
+        BTree tree(t);
+        auto start = chrono::steady_clock::now();
+        for (const Op& op : ops) {
+            if (op.erase) {
+                tree.deleteKey(op.key);
+            } else {
+                tree.insert(op.key);
+            }
+        }
+        double ingestNs = nsPerOp(start, ops.size());
+        probe(hits, misses, [&tree](int key) { return tree.search(key) != nullptr; }, hitNs, missNs);
+        int depth = 0;
+        for (const BTreeNode* node = tree.root; node != nullptr; node = node->isLeaf ? nullptr : node->children[0]) {
+            depth++;
+        }
+        row("btree_t" + to_string(t), "-", ops.size(), ingestNs, hitNs, missNs, depth, 0);
+    }
+
+    const pair<int, int> shapes[] = {{16, 256}, {16, 1024}, {16, 4096}, {64, 1024}, {64, 4096}};
+    for (const pair<int, int>& shape : shapes) {
+        BEpsilonTree tree(256, shape.first, shape.second);
+        auto start = chrono::steady_clock::now();
+        for (const Op& op : ops) {
+            if (op.erase) {
+                tree.erase(op.key);
+            } else {
+                tree.insert(op.key);
+            }
+        }
+        double ingestNs = nsPerOp(start, ops.size());
+        string name = "bepsilon_f" + to_string(shape.first) + "_buf" + to_string(shape.second);
+        probe(hits, misses, [&tree](int key) { return tree.contains(key); }, hitNs, missNs);
+        row(name, "buffered", ops.size(), ingestNs, hitNs, missNs, tree.depth(), tree.pendingMessages());
+        tree.flush();
+        probe(hits, misses, [&tree](int key) { return tree.contains(key); }, hitNs, missNs);
+        row(name, "flushed", ops.size(), 0, hitNs, missNs, tree.depth(), tree.pendingMessages());
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Duplicate-heavy input: BSTree, which keeps one counted node per distinct key, against RBTree,
+// which stores every copy as its own node.
+//
+// usage: duplicates_bench [inserts=1000000] [distinct=10,1000,100000,1000000] [seed=1]
+//
+// For each cardinality, `inserts` keys drawn uniformly from `distinct` values are inserted in
+// random order, looked up once each, and deleted one copy at a time (search + del / RBDelete)
+// until the tree is empty. Columns: ns/op for each phase and the RSS growth while the tree was
+// built, in bytes per inserted key.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../RBTreeOperations.h"
+
+#ifdef __linux__
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+volatile size_t resultSink;
+
+long currentRssKb() {
+#ifdef __linux__
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    long pages = 0, resident = 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
+
+// Hands freed heap pages back so the next tree's RSS growth is not hidden by reuse.
+void releaseFreedMemory() {
+#if defined(__linux__) && defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+template <typename Tree, typename Insert, typename Remove>
+void run(const char* name, size_t distinct, const vector<int>& keys, Insert insert, Remove remove) {
+    releaseFreedMemory();
+    long rssBefore = currentRssKb();
+    Tree tree;
+    auto start = chrono::steady_clock::now();
+    for (int key : keys) {
+        insert(tree, key);
+    }
+    double insertNs = nsPerOp(start, keys.size());
+    double rssBytesPerKey = (currentRssKb() - rssBefore) * 1024.0 / keys.size();
+
+    size_t depth = tree.depth();
+    size_t sum = 0;
+    start = chrono::steady_clock::now();
+    for (int key : keys) {
+        sum += tree.search(tree.root, key)->key;
+    }
+    double searchNs = nsPerOp(start, keys.size());
+    resultSink = sum;
+
+    start = chrono::steady_clock::now();
+    for (int key : keys) {
+        remove(tree, key);
+    }
+    double deleteNs = nsPerOp(start, keys.size());
+
+    cout << name << "," << keys.size() << "," << distinct << "," << depth << "," << insertNs << "," << searchNs
+         << "," << deleteNs << "," << rssBytesPerKey << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    vector<size_t> cardinalities = {10, 1000, 100000, 1000000};
+    if (argc > 2) {
+        cardinalities.clear();
+        stringstream list(argv[2]);
+        string item;
+        while (getline(list, item, ',')) {
+            cardinalities.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "tree,inserts,distinct,depth,insert_ns,search_ns,delete_ns,rss_bytes_per_key\n";
+    for (size_t distinct : cardinalities) {
+        vector<int> keys(count);
+        for (int& key : keys) {
+            key = static_cast<int>(rng() % distinct);
+        }
+
+        run<BSTree>("bst", distinct, keys, [](BSTree& tree, int key) { tree.insert(key); },
+                    [](BSTree& tree, int key) { tree.del(tree.search(tree.root, key)); });
+        run<RBTree>("rb", distinct, keys, [](RBTree& tree, int key) { tree.RBInsert(key); },
+                    [](RBTree& tree, int key) { tree.RBDelete(tree.search(tree.root, key)); });
+    }
+    return 0;
+}
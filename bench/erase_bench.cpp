@@ -0,0 +1,98 @@
+// Bulk deletes on the red-black tree: eraseBatch() against one erase() per key, in random and in
+// sorted order, and against the search() + RBDelete() pair it replaces.
+//
+// usage: erase_bench [keys=1000000] [percents=1,2,5,10,20,50,80,95] [seed=1]
+//
+// For each batch size, a fresh tree gets `keys` distinct keys in random order, and a random
+// `percent` of them is deleted. The per-key methods take the batch in random order, erase_sorted
+// and eraseBatch() take it sorted; the sort is not timed. eraseBatch() erases key by key below
+// 1/16 of the tree, with finger searches up to 75%, and rebuilds above. Prints ns per deleted key for each method (CSV).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+template <typename Erase>
+void run(const char* method, const vector<int>& keys, double percent, const vector<int>& batch, Erase erase) {
+    RBTree tree;
+    for (int key : keys) {
+        tree.RBInsert(key);
+    }
+    auto start = chrono::steady_clock::now();
+    size_t removed = erase(tree, batch);
+    double ns = nsPerOp(start, batch.size());
+    if (removed != batch.size() || tree.size() != keys.size() - batch.size()) {
+        cerr << method << ": removed " << removed << " of " << batch.size() << " keys\n";
+        exit(1);
+    }
+    cout << method << "," << keys.size() << "," << percent << "," << batch.size() << "," << ns << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    vector<double> percents = {1, 2, 5, 10, 20, 50, 80, 95};
+    if (argc > 2) {
+        percents.clear();
+        stringstream list(argv[2]);
+        string item;
+        while (getline(list, item, ',')) {
+            percents.push_back(atof(item.c_str()));
+        }
+    }
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    vector<int> keys(count);
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = static_cast<int>(i);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+
+    cout << "method,keys,percent,deletes,ns_per_delete\n";
+    for (double percent : percents) {
+        vector<int> batch(keys.begin(), keys.begin() + static_cast<size_t>(count * percent / 100));
+        shuffle(keys.begin(), keys.end(), rng);
+
+        run("search+RBDelete", keys, percent, batch, [](RBTree& tree, const vector<int>& batch) {
+            size_t removed = 0;
+            for (int key : batch) {
+                RBNode* node = tree.search(tree.root, key);
+                if (node != NIL) {
+                    tree.RBDelete(node);
+                    removed++;
+                }
+            }
+            return removed;
+        });
+        run("erase", keys, percent, batch, [](RBTree& tree, const vector<int>& batch) {
+            size_t removed = 0;
+            for (int key : batch) {
+                removed += tree.erase(key);
+            }
+            return removed;
+        });
+        sort(batch.begin(), batch.end());
+        run("erase_sorted", keys, percent, batch, [](RBTree& tree, const vector<int>& batch) {
+            size_t removed = 0;
+            for (int key : batch) {
+                removed += tree.erase(key);
+            }
+            return removed;
+        });
+        run("eraseBatch", keys, percent, batch, [](RBTree& tree, const vector<int>& batch) {
+            return tree.eraseBatch(batch);
+        });
+    }
+    return 0;
+}
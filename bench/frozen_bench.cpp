@@ -0,0 +1,87 @@
+// Lookup throughput of a frozen Eytzinger snapshot against the pointer-based trees it was taken
+// from, and against binary search over the sorted keys.
+//
+// usage: frozen_bench [sizes=1000,100000,1000000,10000000] [probes=2000000] [seed=1]
+//
+// For each size, n distinct even keys are inserted in random order into a BSTree and an RBTree,
+// and the RBTree is frozen. Every structure then answers the same probes, half present keys and
+// half absent odd keys, in random order. Prints millions of lookups per second (CSV).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../FrozenTree.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+template <typename Lookup>
+void measure(const char* name, size_t n, const vector<int>& probes, Lookup lookup) {
+    size_t sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : probes) {
+        sum += lookup(key);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    resultSink = sum;
+    cout << name << "," << n << "," << probes.size() / seconds / 1e6 << "\n";
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {1000, 100000, 1000000, 10000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "structure,keys,mlookups_per_s\n";
+    for (size_t n : sizes) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = static_cast<int>(2 * i);
+        }
+        vector<int> probes(probeCount);
+        for (int& key : probes) {
+            key = static_cast<int>(rng() % (2 * n));
+        }
+        shuffle(keys.begin(), keys.end(), rng);
+
+        {
+            BSTree bst;
+            for (int key : keys) {
+                bst.insert(key);
+            }
+            measure("bst.search", n, probes, [&bst](int key) { return bst.search(bst.root, key) != nullptr; });
+        }
+
+        RBTree rb;
+        for (int key : keys) {
+            rb.RBInsert(key);
+        }
+        measure("rb.search", n, probes, [&rb](int key) { return rb.search(rb.root, key) != NIL; });
+
+        FrozenTree<int> frozen = rb.freeze();
+        measure("frozen.contains", n, probes, [&frozen](int key) { return frozen.contains(key); });
+        measure("frozen.lower_bound", n, probes, [&frozen](int key) { return frozen.lowerBound(key) != nullptr; });
+        measure("frozen.rank", n, probes, [&frozen](int key) { return frozen.rank(key); });
+
+        sort(keys.begin(), keys.end());
+        measure("sorted.binary_search", n, probes,
+                [&keys](int key) { return binary_search(keys.begin(), keys.end(), key); });
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Key file ingestion: istringstream into std::list (the interactive path) versus the
+// memory-mapped parallel parser, for text and binary key files.
+//
+// usage: ingest_bench [keys=20000000] [directory=.]
+// Prints one CSV row per reader and thread count.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../IODialog.h"
+
+using namespace std;
+
+double elapsedSeconds(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* reader, unsigned threads, size_t keys, uintmax_t bytes, double seconds) {
+    cout << reader << "," << threads << "," << keys << "," << bytes << "," << seconds << ","
+         << bytes / seconds / (1 << 20) << "," << keys / seconds << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 20000000;
+    string directory = argc > 2 ? argv[2] : ".";
+    string textPath = (filesystem::path(directory) / "ingest_bench.txt").string();
+    string binaryPath = (filesystem::path(directory) / "ingest_bench.bin").string();
+
+    mt19937 rng(7);
+    vector<int> source(count);
+    for (int& key : source) {
+        key = static_cast<int>(rng());
+    }
+    {
+        FILE* text = fopen(textPath.c_str(), "wb");
+        FILE* binary = fopen(binaryPath.c_str(), "wb");
+        if (text == nullptr || binary == nullptr) {
+            cerr << "cannot create key files in " << directory << "\n";
+            return 1;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            fprintf(text, "%d%c", source[i], (i % 16 == 15) ? '\n' : ' ');
+        }
+        fwrite(source.data(), sizeof(int), count, binary);
+        fclose(text);
+        fclose(binary);
+    }
+    uintmax_t textBytes = filesystem::file_size(textPath);
+    uintmax_t binaryBytes = filesystem::file_size(binaryPath);
+
+    cout << "reader,threads,keys,bytes,seconds,mib_per_sec,keys_per_sec\n";
+    {
+        auto start = chrono::steady_clock::now();
+        ifstream in(textPath);
+        list<int> keys;
+        string line;
+        while (getline(in, line)) {
+            istringstream iss(line);
+            int key;
+            while (iss >> key) {
+                keys.push_back(key);
+            }
+        }
+        report("getline_istringstream_list", 1, keys.size(), textBytes, elapsedSeconds(start));
+    }
+
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned threads : threadCounts) {
+        for (IODialog::KeyFileFormat format : {IODialog::KeyFileFormat::Text, IODialog::KeyFileFormat::Binary}) {
+            bool binary = format == IODialog::KeyFileFormat::Binary;
+            vector<int> keys;
+            auto start = chrono::steady_clock::now();
+            if (!IODialog::readKeyFile(binary ? binaryPath : textPath, format, keys, threads) || keys != source) {
+                cerr << "readKeyFile returned wrong keys\n";
+                return 1;
+            }
+            report(binary ? "mmap_binary" : "mmap_text", threads, keys.size(),
+                   binary ? binaryBytes : textBytes, elapsedSeconds(start));
+        }
+    }
+
+    filesystem::remove(textPath);
+    filesystem::remove(binaryPath);
+    return 0;
+}
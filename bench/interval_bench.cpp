@@ -0,0 +1,105 @@
+// Overlap queries: IntervalTree against a linear scan over the same intervals.
+//
+// usage: interval_bench [sizes=10000,100000,1000000] [queries=200000] [seed=1]
+//
+// For each size n, n intervals start uniformly in [0, 100n) and are 0-1000 long, so a point lies
+// in about 5 of them. Each structure answers the same stabbing queries and 10000-wide window
+// queries; both must report the same number of intervals. The scan answers at most 2e8 / n of
+// the queries, so it finishes in reasonable time on large sets. Prints nanoseconds per query and
+// the mean number of intervals reported (CSV).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../IntervalTree.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+struct Timing {
+    double ns;
+    size_t reported;
+};
+
+template <typename Query>
+Timing measure(const vector<Interval<int>>& queries, size_t count, Query query) {
+    size_t reported = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        reported += query(queries[i]);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / count;
+    resultSink = reported;
+    return {ns, reported};
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {10000, 100000, 1000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t queryCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "structure,intervals,query,ns_per_query,mean_reported\n";
+    for (size_t n : sizes) {
+        int span = static_cast<int>(100 * n);
+        vector<Interval<int>> intervals(n);
+        IntervalTree tree;
+        for (Interval<int>& interval : intervals) {
+            interval.low = static_cast<int>(rng() % span);
+            interval.high = interval.low + static_cast<int>(rng() % 1001);
+            tree.insert(interval);
+        }
+
+        for (int width : {0, 10000}) {
+            const char* name = width == 0 ? "stab" : "window";
+            vector<Interval<int>> queries(queryCount);
+            for (Interval<int>& query : queries) {
+                query.low = static_cast<int>(rng() % span);
+                query.high = query.low + width;
+            }
+
+            vector<IntervalTree::Node*> out;
+            Timing treeTiming = measure(queries, queryCount, [&](const Interval<int>& q) {
+                out.clear();
+                return tree.overlapping(q, out);
+            });
+            size_t scanCount = min(queryCount, max<size_t>(1, 200000000 / n));
+            Timing scanTiming = measure(queries, scanCount, [&](const Interval<int>& q) {
+                size_t found = 0;
+                for (const Interval<int>& interval : intervals) {
+                    found += interval.low <= q.high && q.low <= interval.high;
+                }
+                return found;
+            });
+
+            out.clear();
+            size_t treeReported = 0;
+            for (size_t i = 0; i < scanCount; i++) {
+                treeReported += tree.overlapping(queries[i], out);
+            }
+            if (treeReported != scanTiming.reported) {
+                cerr << "tree reported " << treeReported << " overlaps, scan " << scanTiming.reported << "\n";
+                return 1;
+            }
+
+            cout << "interval_tree," << n << "," << name << "," << treeTiming.ns << ","
+                 << static_cast<double>(treeTiming.reported) / queryCount << "\n";
+            cout << "linear_scan," << n << "," << name << "," << scanTiming.ns << ","
+                 << static_cast<double>(scanTiming.reported) / scanCount << "\n";
+        }
+    }
+    return 0;
+}
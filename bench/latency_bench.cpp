@@ -0,0 +1,124 @@
+// Cost of OpLatency timing: runs an insert/search/delete workload on each tree with timing off
+// and on and reports the slowdown, then prints the percentiles the timed operations recorded.
+//
+// usage: latency_bench [keys=1000000] [rounds=3]
+//
+// Within every phase the two modes alternate in blocks of BLOCK operations on the same tree, so
+// both see the same tree shape, node layout and machine noise. ns/op is each mode's total time
+// over its operations. The overhead is the median over timed blocks of the block's ns/op divided
+// by the mean of its two untimed neighbours: comparing against both neighbours cancels drift
+// within the phase, and the median keeps a stall in a single block (page faults, preemption)
+// from deciding the result.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../BTreeOperations.h"
+#include "../OpLatency.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+const size_t BLOCK = 4096;
+
+struct ModeTotals {
+    double ns[2] = {0, 0};      // [timing off, timing on]
+    size_t ops[2] = {0, 0};
+    vector<double> pairRatios;  // timed block ns/op over the mean of its untimed neighbours
+
+    double nsPerOp(int mode) const { return ops[mode] == 0 ? 0.0 : ns[mode] / ops[mode]; }
+
+    double medianRatio() {
+        if (pairRatios.empty()) return 1.0;
+        auto middle = pairRatios.begin() + pairRatios.size() / 2;
+        nth_element(pairRatios.begin(), middle, pairRatios.end());
+        return *middle;
+    }
+};
+
+volatile size_t resultSink;
+
+// Runs op(i) for i in [begin, end), switching the timing mode every BLOCK operations.
+template <typename Op>
+void alternate(size_t begin, size_t end, size_t step, ModeTotals& totals, Op op) {
+    size_t block = 0;
+    vector<double> blockNsPerOp;
+    for (size_t first = begin; first < end; first += BLOCK * step, ++block) {
+        int mode = static_cast<int>(block % 2);
+        OpLatency::setEnabled(mode == 1);
+        size_t last = min(end, first + BLOCK * step);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = first; i < last; i += step) {
+            op(i);
+        }
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        size_t ops = (last - first + step - 1) / step;
+        totals.ns[mode] += ns;
+        totals.ops[mode] += ops;
+        if (ops == BLOCK) blockNsPerOp.push_back(ns / ops);
+    }
+    for (size_t i = 1; i + 1 < blockNsPerOp.size(); i += 2) {
+        totals.pairRatios.push_back(blockNsPerOp[i] / ((blockNsPerOp[i - 1] + blockNsPerOp[i + 1]) / 2));
+    }
+    OpLatency::setEnabled(false);
+}
+
+void report(const char* tree, const char* op, ModeTotals& totals) {
+    cout << tree << "," << op << "," << totals.nsPerOp(0) << "," << totals.nsPerOp(1) << ","
+         << (totals.medianRatio() - 1.0) * 100.0 << "\n";
+}
+
+template <typename Tree, typename Make, typename Insert, typename Search, typename Delete>
+void compare(const char* name, const vector<int>& keys, int rounds, Make make, Insert insert, Search search,
+             Delete remove) {
+    ModeTotals inserts, searches, deletes;
+    for (int round = 0; round < rounds; ++round) {
+        Tree* tree = make();
+        alternate(0, keys.size(), 1, inserts, [&](size_t i) { insert(*tree, keys[i]); });
+        size_t found = 0;
+        alternate(0, keys.size(), 1, searches, [&](size_t i) { found += search(*tree, keys[i]); });
+        resultSink = found;
+        alternate(0, keys.size(), 2, deletes, [&](size_t i) { remove(*tree, keys[i]); });
+        delete tree;
+    }
+    report(name, "insert", inserts);
+    report(name, "search", searches);
+    report(name, "delete", deletes);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 3;
+
+    mt19937 rng(11);
+    vector<int> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<int>(i);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+
+    cout << "tree,op,ns_per_op_off,ns_per_op_on,overhead_pct\n";
+    compare<BSTree>("bst", keys, rounds, [] { return new BSTree(); },
+                    [](BSTree& tree, int key) { tree.insert(tree.createNode(key)); },
+                    [](BSTree& tree, int key) { return tree.search(tree.root, key) != nullptr; },
+                    [](BSTree& tree, int key) { tree.del(tree.search(tree.root, key)); });
+    compare<RBTree>("rb", keys, rounds, [] { return new RBTree(); },
+                    [](RBTree& tree, int key) { tree.RBInsert(key); },
+                    [](RBTree& tree, int key) { return tree.search(tree.root, key) != NIL; },
+                    [](RBTree& tree, int key) {
+                        RBNode* node = tree.search(tree.root, key);
+                        if (node != NIL) tree.RBDelete(node);
+                    });
+    compare<BTree>("btree_t32", keys, rounds, [] { return new BTree(32); },
+                        [](BTree& tree, int key) { tree.insert(key); },
+                        [](BTree& tree, int key) { return tree.search(key) != nullptr; },
+                        [](BTree& tree, int key) { tree.deleteKey(key); });
+
+    cout << "\n";
+    OpLatency::report(cout);
+    return 0;
+}
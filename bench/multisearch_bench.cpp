@@ -0,0 +1,100 @@
+// Sorted batch lookups: BSTree/RBTree multiSearch() against one search() call per key.
+//
+// usage: multisearch_bench [sizes=100000,1000000,10000000] [probes=2000000] [seed=1]
+//
+// For each size, n distinct even keys are inserted in random order into a BSTree and an RBTree.
+// Both answer the same probes, half present keys and half absent odd keys, in random order. The
+// batched rows hand them to multiSearch() in chunks of `batch` keys, sorting included. Prints
+// millions of lookups per second and the speedup over the single-key loop (CSV); every batch
+// result is checked against search().
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+template <typename Tree>
+bool measure(const char* name, size_t n, Tree& tree, const vector<int>& probes) {
+    using TreeNode = typename Tree::Node;
+    vector<TreeNode*> expected(probes.size());
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < probes.size(); i++) {
+        expected[i] = tree.search(tree.root, probes[i]);
+    }
+    double single = probes.size() / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+    cout << name << "," << n << ",search,1," << single << ",1\n";
+
+    for (size_t batch : {16, 256, 4096, 65536}) {
+        vector<int> chunk;
+        vector<TreeNode*> results;
+        size_t sum = 0;
+        start = chrono::steady_clock::now();
+        for (size_t first = 0; first < probes.size(); first += batch) {
+            chunk.assign(probes.begin() + first, probes.begin() + min(first + batch, probes.size()));
+            tree.multiSearch(chunk, results);
+            for (size_t i = 0; i < results.size(); i++) {
+                sum += reinterpret_cast<size_t>(results[i]);
+                if (results[i] != expected[first + i]) {
+                    cerr << name << ".multiSearch disagrees with search for key " << chunk[i] << "\n";
+                    return false;
+                }
+            }
+        }
+        double rate = probes.size() / chrono::duration<double>(chrono::steady_clock::now() - start).count() / 1e6;
+        resultSink = sum;
+        cout << name << "," << n << ",multiSearch," << batch << "," << rate << "," << rate / single << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {100000, 1000000, 10000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "tree,keys,method,batch,mlookups_per_s,speedup\n";
+    for (size_t n : sizes) {
+        vector<int> keys(n);
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = static_cast<int>(2 * i);
+        }
+        shuffle(keys.begin(), keys.end(), rng);
+        vector<int> probes(probeCount);
+        for (int& key : probes) {
+            key = static_cast<int>(rng() % (2 * n));
+        }
+
+        {
+            BSTree bst;
+            for (int key : keys) {
+                bst.insert(key);
+            }
+            if (!measure("bst", n, bst, probes)) return 1;
+        }
+
+        RBTree rb;
+        for (int key : keys) {
+            rb.RBInsert(key);
+        }
+        if (!measure("rb", n, rb, probes)) return 1;
+    }
+    return 0;
+}
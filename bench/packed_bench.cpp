@@ -0,0 +1,161 @@
+// Bit-packed leaves: PackedBTree against BTree on footprint and lookup speed.
+//
+// usage: packed_bench [keys=2000000] [probes=1000000] [seed=1]
+//
+// Two key sets: dense (key i is 3i plus 0-2, the case the encoding targets) and sparse (distinct
+// uniform 31-bit keys, where a packed leaf still needs about 20 bits per key). Each tree is built
+// twice, bulk-loaded from the sorted keys and by inserting them in random order, and probed with
+// present and absent keys in random order.
+//
+// bytes_per_key counts what the nodes hold (vectors by capacity, node headers), not allocator
+// overhead; payload_bytes_per_key is the packed key data alone. Insert-built rows add insert_ns.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../BTreeOperations.h"
+#include "../PackedBTree.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+size_t btreeMemory(const BTreeNode* node) {
+    if (node == nullptr) return 0;
+    size_t bytes = sizeof(BTreeNode) + node->keys.capacity() * sizeof(int) +
+                   node->children.capacity() * sizeof(BTreeNode*);
+    for (const BTreeNode* child : node->children) {
+        bytes += btreeMemory(child);
+    }
+    return bytes;
+}
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+struct Probes {
+    vector<int> hits;
+    vector<int> misses;
+};
+
+template <typename Contains>
+void probe(const Probes& probes, Contains contains, double& hitNs, double& missNs) {
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : probes.hits) {
+        found += contains(key);
+    }
+    hitNs = nsPerOp(start, probes.hits.size());
+    start = chrono::steady_clock::now();
+    for (int key : probes.misses) {
+        found += contains(key);
+    }
+    missNs = nsPerOp(start, probes.misses.size());
+    resultSink = found;
+    if (found != probes.hits.size()) {
+        cerr << found << " of " << probes.hits.size() << " lookups found, expected exactly the hits\n";
+        exit(1);
+    }
+}
+
+void row(const char* dataset, const string& tree, const char* build, size_t keys, double insertNs, size_t bytes,
+         size_t payload, double hitNs, double missNs) {
+    cout << dataset << "," << tree << "," << build << "," << keys << ",";
+    if (insertNs > 0) cout << insertNs;
+    cout << "," << static_cast<double>(bytes) / keys << ",";
+    if (payload > 0) cout << static_cast<double>(payload) / keys;
+    cout << "," << hitNs << "," << missNs << "\n";
+}
+
+void runAll(const char* dataset, const vector<int>& sorted, const Probes& probes, mt19937_64& rng) {
+    vector<int> shuffled = sorted;
+    shuffle(shuffled.begin(), shuffled.end(), rng);
+    double hitNs, missNs;
+
+    for (int t : {32, 64}) {
+        string name = "btree_t" + to_string(t);
+        for (bool bulk : {true, false}) {
+            BTree tree(t);
+            double insertNs = 0;
+            if (bulk) {
+                tree.buildFromSorted(sorted);
+            } else {
+                auto start = chrono::steady_clock::now();
+                for (int key : shuffled) {
+                    tree.insert(key);
+                }
+                insertNs = nsPerOp(start, shuffled.size());
+            }
+            probe(probes, [&tree](int key) { return tree.search(key) != nullptr; }, hitNs, missNs);
+            row(dataset, name, bulk ? "bulk" : "insert", sorted.size(), insertNs, btreeMemory(tree.root), 0, hitNs,
+                missNs);
+        }
+    }
+
+    for (int leafKeys : {64, 256}) {
+        string name = "packed_leaf" + to_string(leafKeys);
+        for (bool bulk : {true, false}) {
+            PackedBTree tree(leafKeys);
+            double insertNs = 0;
+            if (bulk) {
+                tree.buildFromSorted(sorted);
+            } else {
+                auto start = chrono::steady_clock::now();
+                for (int key : shuffled) {
+                    tree.insert(key);
+                }
+                insertNs = nsPerOp(start, shuffled.size());
+            }
+            probe(probes, [&tree](int key) { return tree.contains(key); }, hitNs, missNs);
+            row(dataset, name, bulk ? "bulk" : "insert", sorted.size(), insertNs, tree.memoryUsage(),
+                tree.leafPayloadBytes(), hitNs, missNs);
+        }
+    }
+}
+
+Probes makeProbes(const vector<int>& sorted, size_t count, function<int()> candidate, mt19937_64& rng) {
+    Probes probes;
+    unordered_set<int> present(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < count; i++) {
+        probes.hits.push_back(sorted[rng() % sorted.size()]);
+    }
+    while (probes.misses.size() < count) {
+        int key = candidate();
+        if (present.count(key) == 0) probes.misses.push_back(key);
+    }
+    return probes;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+    size_t probeCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "dataset,tree,build,keys,insert_ns,bytes_per_key,payload_bytes_per_key,hit_ns,miss_ns\n";
+
+    vector<int> dense(count);
+    for (size_t i = 0; i < count; i++) {
+        dense[i] = static_cast<int>(i * 3 + rng() % 3);
+    }
+    int denseEnd = dense.back() + 1;
+    runAll("dense", dense, makeProbes(dense, probeCount, [&] { return static_cast<int>(rng() % denseEnd); }, rng),
+           rng);
+
+    unordered_set<int> seen;
+    vector<int> sparse;
+    while (sparse.size() < count) {
+        int key = static_cast<int>(rng() & 0x7fffffff);
+        if (seen.insert(key).second) sparse.push_back(key);
+    }
+    sort(sparse.begin(), sparse.end());
+    runAll("sparse", sparse, makeProbes(sparse, probeCount, [&] { return static_cast<int>(rng() & 0x7fffffff); }, rng),
+           rng);
+    return 0;
+}
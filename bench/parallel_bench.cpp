@@ -0,0 +1,94 @@
+// Parallel tree aggregates: the serial recursions against their TaskPool counterparts.
+//
+// usage: parallel_bench [keys=5000000] [threads=1,2,4,8,16] [reps=3] [seed=1]
+//
+// One BSTree, RBTree and BTree (t = 32) are built from the same random keys. Each aggregate runs
+// serially and then on a pool of every listed size; the best of `reps` runs is reported in
+// milliseconds, with the speedup over the serial run. Results must match the serial ones. The
+// pool is created before timing starts, so thread start-up is not counted.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../ParallelTraversal.h"
+
+using namespace std;
+
+double bestMs(int reps, const function<int()>& aggregate, int& result) {
+    double best = 0;
+    for (int rep = 0; rep < reps; rep++) {
+        auto start = chrono::steady_clock::now();
+        result = aggregate();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (rep == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+struct Aggregate {
+    const char* name;
+    function<int()> serial;
+    function<int(TaskPool&)> parallel;
+};
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 5000000;
+    vector<unsigned> threadCounts = {1, 2, 4, 8, 16};
+    if (argc > 2) {
+        threadCounts.clear();
+        stringstream list(argv[2]);
+        string item;
+        while (getline(list, item, ',')) {
+            threadCounts.push_back(static_cast<unsigned>(strtoul(item.c_str(), nullptr, 10)));
+        }
+    }
+    int reps = argc > 3 ? atoi(argv[3]) : 3;
+    mt19937_64 rng(argc > 4 ? strtoull(argv[4], nullptr, 10) : 1);
+
+    BSTree bst;
+    RBTree rb;
+    BTree bt(32);
+    for (size_t i = 0; i < count; i++) {
+        int key = static_cast<int>(rng() & 0x7fffffff);
+        bst.insert(key);
+        rb.RBInsert(key);
+        bt.insert(key);
+    }
+
+    vector<Aggregate> aggregates = {
+        {"bst.depth", [&] { return bst.depth(); }, [&](TaskPool& pool) { return parallelDepth(pool, bst); }},
+        {"rb.depth", [&] { return rb.depth(); }, [&](TaskPool& pool) { return parallelDepth(pool, rb); }},
+        {"rb.countBlackNodes", [&] { return rb.countBlackNodes(); },
+         [&](TaskPool& pool) { return parallelCountBlackNodes(pool, rb); }},
+        {"btree.depth", [&] { return bt.depth(); }, [&](TaskPool& pool) { return parallelDepth(pool, bt); }},
+        {"btree.keyCount", [&] { return bt.keyCount(); },
+         [&](TaskPool& pool) { return parallelKeyCount(pool, bt); }},
+        {"btree.countLeafNodes", [&] { return bt.countLeafNodes(); },
+         [&](TaskPool& pool) { return parallelCountLeafNodes(pool, bt); }},
+    };
+
+    cout << "aggregate,threads,ms,speedup\n";
+    for (const Aggregate& aggregate : aggregates) {
+        int expected;
+        double serialMs = bestMs(reps, aggregate.serial, expected);
+        cout << aggregate.name << ",serial," << serialMs << ",1\n";
+        for (unsigned threads : threadCounts) {
+            TaskPool pool(threads);
+            int result;
+            double ms = bestMs(reps, [&] { return aggregate.parallel(pool); }, result);
+            if (result != expected) {
+                cerr << aggregate.name << " on " << threads << " threads returned " << result << ", expected "
+                     << expected << "\n";
+                return 1;
+            }
+            cout << aggregate.name << "," << threads << "," << ms << "," << serialMs / ms << "\n";
+        }
+    }
+    return 0;
+}
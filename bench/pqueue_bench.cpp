@@ -0,0 +1,118 @@
+// The trees as a scheduler queue: popMin/insert against std::priority_queue.
+//
+// usage: pqueue_bench [sizes=1000,100000,1000000] [holds=2000000] [seed=1]
+//
+// Classic hold model: the queue is filled with n random due times, then each hold pops the
+// earliest and schedules a new one 1 to 10n after it, so the size stays n. Every queue replays
+// the same delays, and the popped times are summed and compared across queues. The _walk rows
+// find the minimum with a walk down the left spine (BSTree/RBTree) or remove it with a keyed
+// delete (BTree), as before the cached extremes. Prints ns per hold (CSV).
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../BTreeOperations.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+uint64_t expectedSum;
+
+// measure() pushes the key it pops back, so a tree that cannot pop has lost keys.
+[[noreturn]] void ranEmpty() {
+    cerr << "popMin found the queue empty\n";
+    exit(1);
+}
+
+// push(key) schedules, pop() removes and returns the earliest.
+template <typename Push, typename Pop>
+void measure(const string& name, const vector<int>& initial, const vector<int>& delays, Push push, Pop pop) {
+    for (int key : initial) {
+        push(key);
+    }
+    uint64_t sum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int delay : delays) {
+        int due = pop();
+        sum += due;
+        push(due + delay);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / delays.size();
+    if (expectedSum == 0) expectedSum = sum;
+    if (sum != expectedSum) {
+        cerr << name << " popped a different sequence\n";
+        exit(1);
+    }
+    cout << name << "," << initial.size() << "," << delays.size() << "," << ns << "\n";
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {1000, 100000, 1000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t holds = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "queue,size,holds,ns_per_hold\n";
+    for (size_t n : sizes) {
+        vector<int> initial(n);
+        for (int& key : initial) {
+            key = static_cast<int>(rng() % (10 * n));
+        }
+        vector<int> delays(holds);
+        for (int& delay : delays) {
+            delay = 1 + static_cast<int>(rng() % (10 * n));
+        }
+        expectedSum = 0;
+
+        {
+            priority_queue<int, vector<int>, greater<int>> queue;
+            measure("std::priority_queue", initial, delays, [&](int key) { queue.push(key); },
+                    [&] { int key = queue.top(); queue.pop(); return key; });
+        }
+        {
+            RBTree tree;
+            measure("rb_popmin", initial, delays, [&](int key) { tree.RBInsert(key); },
+                    [&] { int key = 0; if (!tree.popMin(&key)) ranEmpty(); return key; });
+        }
+        {
+            RBTree tree;
+            measure("rb_walk", initial, delays, [&](int key) { tree.RBInsert(key); },
+                    [&] { RBNode* node = tree.minimum(tree.root); int key = node->key; tree.RBDelete(node); return key; });
+        }
+        for (int t : {16, 64}) {
+            {
+                BTree tree(t);
+                measure("btree_t" + to_string(t) + "_popmin", initial, delays, [&](int key) { tree.insert(key); },
+                        [&] { int key = 0; if (!tree.popMin(&key)) ranEmpty(); return key; });
+            }
+            BTree tree(t);
+            measure("btree_t" + to_string(t) + "_walk", initial, delays, [&](int key) { tree.insert(key); },
+                    [&] { int key = *tree.findMinimumKey(); tree.deleteKey(key); return key; });
+        }
+        {
+            BSTree tree;
+            measure("bst_popmin", initial, delays, [&](int key) { tree.insert(key); },
+                    [&] { int key = 0; if (!tree.popMin(&key)) ranEmpty(); return key; });
+        }
+        {
+            BSTree tree;
+            measure("bst_walk", initial, delays, [&](int key) { tree.insert(key); },
+                    [&] { Node* node = tree.minimum(tree.root); int key = node->key; tree.del(node); return key; });
+        }
+    }
+    return 0;
+}
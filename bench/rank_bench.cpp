@@ -0,0 +1,128 @@
+// Order statistics on BTree: rank, select and countRange from the subtree counts, against the
+// in-order walk they needed before.
+//
+// usage: rank_bench [sizes=1000000,10000000] [queries=1000000] [t=32] [seed=1]
+//
+// For each size n, n random keys are inserted in random order. Each query kind runs on random
+// arguments; the walk answers at most 2e8 / n of them (it visits about n / 2 keys per query), and
+// its answers must match. countRange queries cover about 1% of the key range. Prints nanoseconds
+// per query (CSV).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+// The walk: visits keys in order until `accept` rejects one and returns how many it accepted.
+// rank walks the keys below its argument, select the first k + 1 keys.
+size_t walk(const BTreeNode* node, const function<bool(int)>& accept, bool& stopped) {
+    size_t count = 0;
+    for (size_t i = 0; i <= node->keys.size() && !stopped; i++) {
+        if (!node->isLeaf) count += walk(node->children[i], accept, stopped);
+        if (i == node->keys.size() || stopped) break;
+        if (!accept(node->keys[i])) {
+            stopped = true;
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+template <typename Query>
+double measure(size_t count, Query query, vector<size_t>& answers) {
+    answers.resize(count);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+        answers[i] = query(i);
+    }
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / count;
+    resultSink = answers.empty() ? 0 : answers.back();
+    return ns;
+}
+
+void row(const char* query, const char* method, size_t n, double ns) {
+    cout << query << "," << method << "," << n << "," << ns << "\n";
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {1000000, 10000000};
+    if (argc > 1) {
+        sizes.clear();
+        stringstream list(argv[1]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t queryCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+    int t = argc > 3 ? atoi(argv[3]) : 32;
+    mt19937_64 rng(argc > 4 ? strtoull(argv[4], nullptr, 10) : 1);
+
+    cout << "query,method,keys,ns_per_query\n";
+    for (size_t n : sizes) {
+        BTree tree(t);
+        for (size_t i = 0; i < n; i++) {
+            tree.insert(static_cast<int>(rng() & 0x7fffffff));
+        }
+        vector<int> points(queryCount);
+        vector<size_t> indexes(queryCount);
+        for (size_t i = 0; i < queryCount; i++) {
+            points[i] = static_cast<int>(rng() & 0x7fffffff);
+            indexes[i] = rng() % n;
+        }
+        int width = 0x7fffffff / 100;
+        size_t walkCount = min(queryCount, max<size_t>(1, 200000000 / n));
+        vector<size_t> fast, slow;
+
+        double ns = measure(queryCount, [&](size_t i) { return tree.rank(points[i]); }, fast);
+        row("rank", "counts", n, ns);
+        ns = measure(walkCount, [&](size_t i) {
+            bool stopped = false;
+            return walk(tree.root, [&](int key) { return key < points[i]; }, stopped);
+        }, slow);
+        row("rank", "walk", n, ns);
+        for (size_t i = 0; i < walkCount; i++) {
+            if (fast[i] != slow[i]) {
+                cerr << "rank(" << points[i] << ") = " << fast[i] << ", the walk counted " << slow[i] << "\n";
+                return 1;
+            }
+        }
+
+        ns = measure(queryCount, [&](size_t i) { return static_cast<size_t>(*tree.select(indexes[i])); }, fast);
+        row("select", "counts", n, ns);
+        ns = measure(walkCount, [&](size_t i) {
+            size_t seen = 0;
+            int found = 0;
+            bool stopped = false;
+            walk(tree.root, [&](int key) {
+                found = key;
+                return seen++ < indexes[i];
+            }, stopped);
+            return static_cast<size_t>(found);
+        }, slow);
+        row("select", "walk", n, ns);
+        for (size_t i = 0; i < walkCount; i++) {
+            if (fast[i] != slow[i]) {
+                cerr << "select(" << indexes[i] << ") = " << fast[i] << ", the walk found " << slow[i] << "\n";
+                return 1;
+            }
+        }
+
+        ns = measure(queryCount, [&](size_t i) {
+            return tree.countRange(points[i], points[i] > 0x7fffffff - width ? 0x7fffffff : points[i] + width);
+        }, fast);
+        row("countRange", "counts", n, ns);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Many tiny indexes: memory per tenant and lookup time for SmallTree against one RBTree or BTree
+// per tenant.
+//
+// usage: smalltree_bench [tenants=1000000] [sizes=4,16,48] [probes=2000000] [seed=1]
+//
+// For each size, every tenant gets that many random keys. Tenants are filled in turn, one key
+// each per round, so their allocations interleave as they would in a service. The RSS growth
+// while the tenants were built is divided by the tenant count; it includes the per-tenant
+// objects themselves. Lookups probe present keys of random tenants. Sizes above 64 show the
+// promoted SmallTree.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../SmallTree.h"
+
+#ifdef __linux__
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+volatile size_t resultSink;
+
+long currentRssKb() {
+#ifdef __linux__
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    long pages = 0, resident = 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
+
+// Hands freed heap pages back so the next run's RSS growth is not hidden by reuse.
+void releaseFreedMemory() {
+#if defined(__linux__) && defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+struct BTreeTenant {
+    BTree tree{16};
+};
+
+struct Probe {
+    size_t tenant;
+    int key;
+};
+
+// makeTenants() returns the container of tenants; insert(tenant, key) and contains(tenant, key)
+// work on one element.
+template <typename Make, typename Insert, typename Contains>
+void run(const char* name, size_t tenants, size_t size, const vector<int>& keys, const vector<Probe>& probes,
+         Make makeTenants, Insert insert, Contains contains) {
+    releaseFreedMemory();
+    long rssBefore = currentRssKb();
+    auto start = chrono::steady_clock::now();
+    auto all = makeTenants();
+    for (size_t round = 0; round < size; round++) {
+        for (size_t tenant = 0; tenant < tenants; tenant++) {
+            insert(all[tenant], keys[tenant * size + round]);
+        }
+    }
+    double insertNs = nsPerOp(start, tenants * size);
+    double bytesPerTenant = (currentRssKb() - rssBefore) * 1024.0 / tenants;
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (const Probe& probe : probes) {
+        found += contains(all[probe.tenant], probe.key);
+    }
+    double searchNs = nsPerOp(start, probes.size());
+    resultSink = found;
+    if (found != probes.size()) {
+        cerr << name << ": " << found << " of " << probes.size() << " probes found\n";
+        exit(1);
+    }
+    cout << name << "," << tenants << "," << size << "," << bytesPerTenant << "," << insertNs << "," << searchNs
+         << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t tenants = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    vector<size_t> sizes = {4, 16, 48};
+    if (argc > 2) {
+        sizes.clear();
+        stringstream list(argv[2]);
+        string item;
+        while (getline(list, item, ',')) {
+            sizes.push_back(strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    size_t probeCount = argc > 3 ? strtoull(argv[3], nullptr, 10) : 2000000;
+    mt19937_64 rng(argc > 4 ? strtoull(argv[4], nullptr, 10) : 1);
+
+    cout << "structure,tenants,keys_per_tenant,bytes_per_tenant,insert_ns,search_ns\n";
+    for (size_t size : sizes) {
+        vector<int> keys(tenants * size);
+        for (int& key : keys) {
+            key = static_cast<int>(rng() & 0x7fffffff);
+        }
+        vector<Probe> probes(probeCount);
+        for (Probe& probe : probes) {
+            probe.tenant = rng() % tenants;
+            probe.key = keys[probe.tenant * size + rng() % size];
+        }
+
+        run("rbtree", tenants, size, keys, probes, [&] { return vector<RBTree>(tenants); },
+            [](RBTree& tree, int key) { tree.RBInsert(key); },
+            [](RBTree& tree, int key) { return tree.search(tree.root, key) != RBTree::NIL; });
+        run("btree_t16", tenants, size, keys, probes, [&] { return vector<BTreeTenant>(tenants); },
+            [](BTreeTenant& tenant, int key) { tenant.tree.insert(key); },
+            [](BTreeTenant& tenant, int key) { return tenant.tree.search(key) != nullptr; });
+        run("small<rbtree>", tenants, size, keys, probes, [&] { return vector<SmallTree<RBTree>>(tenants); },
+            [](SmallTree<RBTree>& tree, int key) { tree.insert(key); },
+            [](SmallTree<RBTree>& tree, int key) { return tree.contains(key); });
+        run("small<btree>", tenants, size, keys, probes, [&] { return vector<SmallTree<BTree>>(tenants); },
+            [](SmallTree<BTree>& tree, int key) { tree.insert(key); },
+            [](SmallTree<BTree>& tree, int key) { return tree.contains(key); });
+        run("small16<rbtree>", tenants, size, keys, probes, [&] { return vector<SmallTree<RBTree, 16>>(tenants); },
+            [](SmallTree<RBTree, 16>& tree, int key) { tree.insert(key); },
+            [](SmallTree<RBTree, 16>& tree, int key) { return tree.contains(key); });
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Cold start: rebuilding each tree with per-key inserts versus loading a binary snapshot.
+//
+// usage: snapshot_bench [keys=1000000] [directory=.]
+// Prints one CSV row per tree.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../BTreeOperations.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+double elapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename Tree, typename Insert>
+void run(const char* name, const vector<int>& keys, const string& path, Tree& built, Tree& loaded, Insert insert) {
+    auto start = chrono::steady_clock::now();
+    for (int key : keys) {
+        insert(built, key);
+    }
+    double insertMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    if (!built.save(path)) {
+        cerr << "save failed: " << path << "\n";
+        exit(1);
+    }
+    double saveMs = elapsedMs(start);
+
+    start = chrono::steady_clock::now();
+    if (!loaded.load(path)) {
+        cerr << "load failed: " << path << "\n";
+        exit(1);
+    }
+    double loadMs = elapsedMs(start);
+
+    uintmax_t bytes = filesystem::file_size(path);
+    filesystem::remove(path);
+    cout << name << "," << keys.size() << "," << insertMs << "," << saveMs << "," << loadMs << ","
+         << bytes << "," << static_cast<double>(bytes) / keys.size() << "\n";
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    string directory = argc > 2 ? argv[2] : ".";
+    string path = (filesystem::path(directory) / "snapshot_bench.snap").string();
+
+    mt19937 rng(42);
+    vector<int> keys(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<int>(i * 3 + rng() % 3);
+    }
+    shuffle(keys.begin(), keys.end(), rng);
+
+    cout << "tree,keys,insert_build_ms,save_ms,load_ms,file_bytes,bytes_per_key\n";
+    {
+        BSTree built, loaded;
+        run("bst", keys, path, built, loaded, [](BSTree& tree, int key) { tree.insert(tree.createNode(key)); });
+    }
+    {
+        RBTree built, loaded;
+        run("rbtree", keys, path, built, loaded, [](RBTree& tree, int key) { tree.RBInsert(key); });
+    }
+    {
+        BTree built(64), loaded(64);
+        run("btree_t64", keys, path, built, loaded, [](BTree& tree, int key) { tree.insert(key); });
+    }
+    return 0;
+}
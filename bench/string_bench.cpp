@@ -0,0 +1,201 @@
+// String keys: StringBTree (prefix-truncated key buffers with cached 4-byte key heads) against
+// BasicBTree and BasicRBTree holding one std::string per key.
+//
+// usage: string_bench [keys=500000] [probes=500000] [seed=1]
+//
+// Two key sets are generated: URLs (a few hundred hosts, a two-level category path and a numeric
+// item id) and file paths (home directories, projects, nested source directories). Each tree is
+// filled in random order and then probed with present keys and with absent keys that share a
+// long prefix with present ones (the last byte changed or a byte appended), which is where a
+// comparison has to look deep into the key. Lookups pass std::string_view, so none of the trees
+// builds a temporary std::string.
+//
+// Columns: ns/op for insert, hit and miss lookups, the RSS growth while the tree was built in
+// bytes per key (the keys themselves average avg_key_bytes), and, in a -DADS_TREE_STATS build,
+// the fraction of StringBTree comparisons that had to read key bytes because the cached heads
+// were equal (empty for the other trees).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include "../BTreeOperations.h"
+#include "../RBTreeOperations.h"
+#include "../StringBTree.h"
+
+#ifdef __linux__
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+volatile size_t resultSink;
+
+long currentRssKb() {
+#ifdef __linux__
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    long pages = 0, resident = 0;
+    if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
+
+// Hands freed heap pages back so the next tree's RSS growth is not hidden by reuse.
+void releaseFreedMemory() {
+#if defined(__linux__) && defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+vector<string> urlKeys(size_t count, mt19937_64& rng) {
+    static const char* const SECTIONS[] = {"products", "blog", "docs", "support", "news", "shop", "api", "users"};
+    unordered_set<string> seen;
+    vector<string> keys;
+    keys.reserve(count);
+    while (keys.size() < count) {
+        string key = "https://www.";
+        key += "site-" + to_string(rng() % 300) + ".example.com/";
+        key += SECTIONS[rng() % 8];
+        key += "/category-" + to_string(rng() % 40) + "/item-" + to_string(100000 + rng() % 900000);
+        if (rng() % 4 == 0) key += "?ref=campaign-" + to_string(rng() % 20);
+        if (seen.insert(key).second) keys.push_back(key);
+    }
+    return keys;
+}
+
+vector<string> pathKeys(size_t count, mt19937_64& rng) {
+    static const char* const DIRS[] = {"src", "include", "test", "docs", "build", "lib", "tools", "assets"};
+    static const char* const EXTENSIONS[] = {".cpp", ".h", ".md", ".json", ".o", ".txt"};
+    unordered_set<string> seen;
+    vector<string> keys;
+    keys.reserve(count);
+    while (keys.size() < count) {
+        string key = "/home/user" + to_string(rng() % 20) + "/projects/project-" + to_string(rng() % 100);
+        int depth = 1 + static_cast<int>(rng() % 4);
+        for (int i = 0; i < depth; i++) {
+            key += "/";
+            key += DIRS[rng() % 8];
+        }
+        key += "/file_" + to_string(rng() % 5000) + EXTENSIONS[rng() % 6];
+        if (seen.insert(key).second) keys.push_back(key);
+    }
+    return keys;
+}
+
+// Absent keys one byte away from present ones.
+vector<string> missKeys(const vector<string>& keys, size_t count, mt19937_64& rng) {
+    unordered_set<string_view> present(keys.begin(), keys.end());
+    vector<string> misses;
+    misses.reserve(count);
+    while (misses.size() < count) {
+        string key = keys[rng() % keys.size()];
+        if (rng() % 2 == 0) key.back() ^= 1; else key.push_back('~');
+        if (present.count(key) == 0) misses.push_back(key);
+    }
+    return misses;
+}
+
+double nsPerOp(chrono::steady_clock::time_point start, size_t ops) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ops;
+}
+
+template <typename Tree, typename Insert, typename Contains>
+void run(const char* dataset, const char* name, const vector<string>& keys, const vector<string>& hits,
+         const vector<string>& misses, double avgKeyBytes, function<Tree*()> make, Insert insert,
+         Contains contains, function<void(Tree*)> destroy, bool reportKeyBytes) {
+    releaseFreedMemory();
+    long rssBefore = currentRssKb();
+    StringBTree::stats.reset();
+
+    Tree* tree = make();
+    auto start = chrono::steady_clock::now();
+    for (const string& key : keys) {
+        insert(*tree, key);
+    }
+    double insertNs = nsPerOp(start, keys.size());
+    double rssBytesPerKey = (currentRssKb() - rssBefore) * 1024.0 / keys.size();
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (const string& key : hits) {
+        found += contains(*tree, string_view(key));
+    }
+    double hitNs = nsPerOp(start, hits.size());
+
+    start = chrono::steady_clock::now();
+    for (const string& key : misses) {
+        found += contains(*tree, string_view(key));
+    }
+    double missNs = nsPerOp(start, misses.size());
+    resultSink = found;
+    if (found != hits.size()) {
+        cerr << name << ": " << found << " of " << hits.size() << " lookups found, expected exactly the hits\n";
+        exit(1);
+    }
+
+    cout << dataset << "," << name << "," << keys.size() << "," << avgKeyBytes << "," << insertNs << "," << hitNs
+         << "," << missNs << "," << rssBytesPerKey << ",";
+    const TreeStats& stats = StringBTree::stats;
+    if (reportKeyBytes && TREE_STATS_ENABLED && stats.comparisons > 0) {
+        cout << static_cast<double>(stats.keyByteComparisons) / stats.comparisons;
+    }
+    cout << "\n";
+    destroy(tree);
+}
+
+void runAll(const char* dataset, const vector<string>& keys, size_t probes, mt19937_64& rng) {
+    vector<string> hits(probes);
+    for (string& key : hits) {
+        key = keys[rng() % keys.size()];
+    }
+    vector<string> misses = missKeys(keys, probes, rng);
+    vector<string> order = keys;
+    shuffle(order.begin(), order.end(), rng);
+    double totalBytes = 0;
+    for (const string& key : keys) {
+        totalBytes += key.size();
+    }
+    double avgKeyBytes = totalBytes / keys.size();
+
+    using StringRB = BasicRBTree<string, NoValue, less<>>;
+    using StringB = BasicBTree<string, NoValue, less<>>;
+    run<StringRB>(dataset, "rbtree_string", order, hits, misses, avgKeyBytes, [] { return new StringRB(); },
+                  [](StringRB& tree, const string& key) { tree.RBInsert(key); },
+                  [](StringRB& tree, string_view key) { return tree.search(tree.root, key) != StringRB::NIL; },
+                  [](StringRB* tree) { delete tree; }, false);
+    run<StringB>(dataset, "btree_string_t32", order, hits, misses, avgKeyBytes, [] { return new StringB(32); },
+                 [](StringB& tree, const string& key) { tree.insert(key); },
+                 [](StringB& tree, string_view key) { return tree.search(key) != nullptr; },
+                 [](StringB* tree) { delete tree; }, false);
+    for (size_t nodeBytes : {1024, 4096}) {
+        string name = "string_btree_" + to_string(nodeBytes / 1024) + "k";
+        run<StringBTree>(dataset, name.c_str(), order, hits, misses, avgKeyBytes,
+                         [nodeBytes] { return new StringBTree(nodeBytes); },
+                         [](StringBTree& tree, const string& key) { tree.insert(key); },
+                         [](StringBTree& tree, string_view key) { return tree.contains(key); },
+                         [](StringBTree* tree) { delete tree; }, true);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 500000;
+    size_t probes = argc > 2 ? strtoull(argv[2], nullptr, 10) : 500000;
+    mt19937_64 rng(argc > 3 ? strtoull(argv[3], nullptr, 10) : 1);
+
+    cout << "dataset,tree,keys,avg_key_bytes,insert_ns,hit_ns,miss_ns,tree_rss_bytes_per_key,key_byte_cmp_fraction\n";
+    runAll("urls", urlKeys(count, rng), probes, rng);
+    runAll("paths", pathKeys(count, rng), probes, rng);
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Replays an operation trace (OpTrace.h) recorded by the menus or batch mode at full speed and
+// reports its throughput and latency.
+//
+// usage: trace_replay trace [tree=recorded] [t] [sample=128]
+//
+// tree is "recorded" (each tree record picks the tree the session used) or bst, rb or btree to
+// replay the whole trace against that tree; t overrides the B-Tree degree. The operations mean
+// what they mean in batch mode; those the replayed tree does not support (range on the
+// red-black tree or B-Tree, successor and predecessor on the B-Tree, kth on the red-black tree)
+// are skipped and counted. A record that starts a new tree frees the old one.
+//
+// The trace runs twice: once untimed for throughput, then once with OpLatency sampling every
+// `sample`-th insert, search and delete (1 times every call) for the percentiles.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../BTreeOperations.h"
+#include "../OpLatency.h"
+#include "../OpTrace.h"
+#include "../RBTreeOperations.h"
+
+using namespace std;
+
+volatile size_t resultSink;
+
+struct Replayer {
+    int forcedKind = -1;    // an OpTrace::TreeKind, or -1 to follow the trace
+    int forcedDegree = 0;
+
+    OpTrace::TreeKind kind = OpTrace::BST;
+    unique_ptr<BSTree> bst;
+    unique_ptr<RBTree> rb;
+    unique_ptr<BTree> bt;
+    vector<int> keys;
+    size_t sink = 0;
+    size_t skipped[OpTrace::OP_COUNT] = {};
+
+    void reset(int recordedKind, int recordedDegree) {
+        bst.reset();
+        rb.reset();
+        bt.reset();
+        kind = static_cast<OpTrace::TreeKind>(forcedKind >= 0 ? forcedKind : recordedKind);
+        switch (kind) {
+            case OpTrace::BST: bst.reset(new BSTree()); break;
+            case OpTrace::RED_BLACK: rb.reset(new RBTree()); break;
+            default:
+                kind = OpTrace::BTREE;
+                bt.reset(new BTree(forcedDegree >= 2 ? forcedDegree : recordedDegree >= 2 ? recordedDegree : 3));
+                break;
+        }
+    }
+
+    void run(const vector<OpTrace::Record>& records) {
+        if (records.empty() || records[0].op != OpTrace::TREE) {
+            reset(OpTrace::BST, 0);    // batch mode's default tree
+        }
+        for (const OpTrace::Record& record : records) {
+            apply(record);
+        }
+        resultSink = sink;
+    }
+
+    void apply(const OpTrace::Record& r) {
+        switch (r.op) {
+            case OpTrace::TREE:
+                reset(r.key, r.high);
+                return;
+            case OpTrace::INSERT:
+                switch (kind) {
+                    case OpTrace::BST: bst->insert(bst->createNode(r.key)); break;
+                    case OpTrace::RED_BLACK: rb->RBInsert(r.key); break;
+                    default: bt->insert(r.key); break;
+                }
+                return;
+            case OpTrace::DELETE:
+                switch (kind) {
+                    case OpTrace::BST: {
+                        Node* node = bst->search(bst->root, r.key);
+                        if (node) bst->del(node);
+                        break;
+                    }
+                    case OpTrace::RED_BLACK: rb->erase(r.key); break;
+                    default: bt->deleteKey(r.key); break;
+                }
+                return;
+            case OpTrace::SEARCH:
+                switch (kind) {
+                    case OpTrace::BST: sink += bst->search(bst->root, r.key) != nullptr; break;
+                    case OpTrace::RED_BLACK: sink += rb->search(rb->root, r.key) != NIL; break;
+                    default: sink += bt->search(r.key) != nullptr; break;
+                }
+                return;
+            case OpTrace::MIN:
+            case OpTrace::MAX:
+                minMax(r.op == OpTrace::MIN);
+                return;
+            case OpTrace::SUCCESSOR:
+            case OpTrace::PREDECESSOR:
+                neighbour(r);
+                return;
+            case OpTrace::KTH:
+            case OpTrace::KTH_LARGEST:
+                kth(r);
+                return;
+            case OpTrace::RANGE:
+                if (kind != OpTrace::BST) break;
+                sink += bst->rangeQuery(r.key, r.high).size();
+                return;
+            case OpTrace::DEPTH:
+                sink += kind == OpTrace::BST ? bst->depth() : kind == OpTrace::RED_BLACK ? rb->depth() : bt->depth();
+                return;
+            case OpTrace::COUNT:
+                if (kind == OpTrace::BTREE) {
+                    sink += bt->size();
+                    return;
+                }
+                [[fallthrough]];
+            case OpTrace::INORDER:
+                keys.clear();
+                switch (kind) {
+                    case OpTrace::BST: bst->collectKeys(bst->root, keys); break;
+                    case OpTrace::RED_BLACK: rb->collectKeys(rb->root, keys); break;
+                    default: bt->collectKeys(keys); break;
+                }
+                sink += keys.size();
+                return;
+            default:
+                break;
+        }
+        skipped[r.op]++;
+    }
+
+    void minMax(bool min) {
+        switch (kind) {
+            case OpTrace::BST:
+                if (bst->root) sink += (min ? bst->minimum() : bst->maximum())->key;
+                break;
+            case OpTrace::RED_BLACK:
+                if (rb->root != NIL) sink += (min ? rb->minimum() : rb->maximum())->key;
+                break;
+            default:
+                if (bt->root) sink += *(min ? bt->findMinimumKey() : bt->findMaximumKey());
+                break;
+        }
+    }
+
+    void neighbour(const OpTrace::Record& r) {
+        bool next = r.op == OpTrace::SUCCESSOR;
+        if (kind == OpTrace::BST) {
+            Node* node = bst->search(bst->root, r.key);
+            if (node == nullptr) return;
+            Node* result = next ? bst->successor(node) : bst->predecessor(node);
+            if (result) sink += result->key;
+        } else if (kind == OpTrace::RED_BLACK) {
+            RBNode* node = rb->search(rb->root, r.key);
+            if (node == NIL) return;
+            RBNode* result = next ? rb->successor(node) : rb->predecessor(node);
+            if (result != NIL) sink += result->key;
+        } else {
+            skipped[r.op]++;
+        }
+    }
+
+    void kth(const OpTrace::Record& r) {
+        bool smallest = r.op == OpTrace::KTH;
+        if (kind == OpTrace::BST) {
+            Node* result = smallest ? bst->kthSmallest(r.key) : bst->kthLargest(r.key);
+            if (result) sink += result->key;
+        } else if (kind == OpTrace::BTREE) {
+            size_t size = bt->size();
+            if (r.key >= 1 && static_cast<size_t>(r.key) <= size) {
+                sink += *bt->select(smallest ? r.key - 1 : size - r.key);
+            }
+        } else {
+            skipped[r.op]++;
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        cerr << "usage: trace_replay trace [tree=recorded|bst|rb|btree] [t] [sample=128]\n";
+        return 1;
+    }
+    vector<OpTrace::Record> records;
+    if (!OpTrace::read(argv[1], records)) {
+        cerr << "cannot read trace '" << argv[1] << "'\n";
+        return 1;
+    }
+    string tree = argc > 2 ? argv[2] : "recorded";
+    int forcedKind = -1;
+    if (tree == "bst") {
+        forcedKind = OpTrace::BST;
+    } else if (tree == "rb") {
+        forcedKind = OpTrace::RED_BLACK;
+    } else if (tree == "btree") {
+        forcedKind = OpTrace::BTREE;
+    } else if (tree != "recorded") {
+        cerr << "unknown tree '" << tree << "' (expected recorded, bst, rb or btree)\n";
+        return 1;
+    }
+    int degree = argc > 3 ? atoi(argv[3]) : 0;
+    uint32_t sample = argc > 4 ? static_cast<uint32_t>(strtoul(argv[4], nullptr, 10)) : OpLatency::DEFAULT_SAMPLE_INTERVAL;
+
+    size_t counts[OpTrace::OP_COUNT] = {};
+    for (const OpTrace::Record& record : records) {
+        counts[record.op]++;
+    }
+    cout << records.size() << " operations:";
+    for (int op = 0; op < OpTrace::OP_COUNT; op++) {
+        if (counts[op] != 0) cout << " " << OpTrace::name(static_cast<OpTrace::Op>(op)) << "=" << counts[op];
+    }
+    cout << "\n";
+
+    double seconds;
+    {
+        Replayer replayer;
+        replayer.forcedKind = forcedKind;
+        replayer.forcedDegree = degree;
+        auto start = chrono::steady_clock::now();
+        replayer.run(records);
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        for (int op = 0; op < OpTrace::OP_COUNT; op++) {
+            if (replayer.skipped[op] != 0) {
+                cout << "skipped " << replayer.skipped[op] << " " << OpTrace::name(static_cast<OpTrace::Op>(op))
+                     << " (not supported by the replayed tree)\n";
+            }
+        }
+    }
+    cout << "replay: " << seconds * 1e3 << " ms, " << records.size() / seconds / 1e6 << " Mops/s\n";
+
+    {
+        Replayer replayer;
+        replayer.forcedKind = forcedKind;
+        replayer.forcedDegree = degree;
+        OpLatency::setEnabled(true, sample < 1 ? 1 : sample);
+        replayer.run(records);
+        OpLatency::setEnabled(false);
+    }
+    OpLatency::report(cout);
+    return 0;
+}
@@ -0,0 +1,507 @@
+// Comparative benchmark of BSTree, RBTree and BTree.
+//
+// usage: tree_bench [--sizes 1000,10000,100000,1000000] [--dists sorted,reverse,uniform,zipf]
+//                   [--trees bst,rb,btree] [--degrees 2,8,32,128] [--probes 10000]
+//                   [--samples 100000] [--bst-degenerate-limit 20000] [--seed 1] [--format csv|json]
+//                   [--perf]
+//
+// For every tree, size and distribution the tree is filled with n distinct even keys, then
+// searched (hits and misses), queried and finally partly emptied. The distribution decides the
+// insertion order (ascending, descending, or shuffled for uniform and zipf) and the order of the
+// probe keys (ascending, descending, uniform, or Zipf(0.99)-skewed towards a fixed hot set).
+// Operations a tree does not provide are skipped. A BST filled in sorted or reverse order is a
+// linked list, so those runs are skipped above --bst-degenerate-limit keys.
+//
+// Each row reports ns/op over the whole phase and latency percentiles over up to --samples
+// individually timed operations, plus the process peak RSS and the RSS growth while the tree
+// was built. Built with -DADS_TREE_STATS, rows also carry per-operation structural counters
+// (comparisons, nodes visited, rotations, fixup iterations, splits, merges/borrows, successor
+// steps); otherwise those columns are 0.
+//
+// --perf (Linux) wraps each phase in perf_event_open counters and adds cycles, instructions,
+// IPC, L1D and LLC read misses and branch misses per operation. Individual operations are not
+// timed in this mode, since the extra clock reads would show up in the counts, so the latency
+// percentile columns are 0. Counters the kernel refuses (perf_event_paranoid, virtual machines)
+// are left empty (null in JSON).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../BSTOperations.h"
+#include "../BTreeOperations.h"
+#include "../RBTreeOperations.h"
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    struct Options {
+        vector<size_t> sizes = {1000, 10000, 100000, 1000000};
+        vector<string> distributions = {"sorted", "reverse", "uniform", "zipf"};
+        vector<string> trees = {"bst", "rb", "btree"};
+        vector<int> degrees = {2, 8, 32, 128};
+        size_t probes = 10000;
+        size_t samples = 100000;
+        size_t bstDegenerateLimit = 20000;
+        uint64_t seed = 1;
+        bool json = false;
+        bool perf = false;
+    };
+
+    // Zipf-distributed ranks in [0, n) after Gray et al., "Quickly generating billion-record
+    // synthetic databases" (the YCSB generator); O(n) setup, O(1) memory.
+    class ZipfGenerator {
+    public:
+        ZipfGenerator(size_t n, double theta) : n(n), theta(theta) {
+            double zeta2 = 1.0 + pow(0.5, theta);
+            for (size_t i = 1; i <= n; ++i) {
+                zetaN += 1.0 / pow(static_cast<double>(i), theta);
+            }
+            alpha = 1.0 / (1.0 - theta);
+            eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetaN);
+        }
+
+        size_t operator()(mt19937_64& rng) {
+            double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+            double uz = u * zetaN;
+            if (uz < 1.0) return 0;
+            if (uz < 1.0 + pow(0.5, theta)) return min<size_t>(1, n - 1);
+            return min(n - 1, static_cast<size_t>(n * pow(eta * u - eta + 1.0, alpha)));
+        }
+
+    private:
+        size_t n;
+        double theta;
+        double zetaN = 0.0;
+        double alpha;
+        double eta;
+    };
+
+    long peakRssKb() {
+#ifdef __linux__
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+#else
+        return 0;
+#endif
+    }
+
+    long currentRssKb() {
+#ifdef __linux__
+        FILE* statm = fopen("/proc/self/statm", "r");
+        if (statm == nullptr) return 0;
+        long pages = 0, resident = 0;
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        fclose(statm);
+        return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+        return 0;
+#endif
+    }
+
+    struct Row {
+        string tree;
+        int degree;
+        string distribution;
+        size_t n;
+        string op;
+        size_t count;
+        double nsPerOp;
+        vector<uint64_t> latencies;
+        long treeRssKb;
+        TreeStats counters;
+        PerfCounters::Reading perf;
+    };
+
+    double perOp(uint64_t total, size_t count) {
+        return count == 0 ? 0.0 : static_cast<double>(total) / count;
+    }
+
+    class Reporter {
+    public:
+        explicit Reporter(bool json) : json(json) {
+            if (json) {
+                cout << "[\n";
+            } else {
+                cout << "tree,degree,distribution,n,op,count,ns_per_op,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,"
+                        "peak_rss_kb,tree_rss_kb,cmp_per_op,nodes_per_op,rotations_per_op,fixups_per_op,"
+                        "splits_per_op,merges_per_op,successor_steps_per_op,cycles_per_op,instructions_per_op,ipc,"
+                        "l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op\n";
+            }
+        }
+
+        ~Reporter() {
+            if (json) cout << "\n]\n";
+        }
+
+        void emit(Row& row) {
+            sort(row.latencies.begin(), row.latencies.end());
+            uint64_t p50 = percentile(row.latencies, 0.50), p90 = percentile(row.latencies, 0.90);
+            uint64_t p99 = percentile(row.latencies, 0.99), p999 = percentile(row.latencies, 0.999);
+            uint64_t max = row.latencies.empty() ? 0 : row.latencies.back();
+            const TreeStats& c = row.counters;
+            double counters[] = {
+                    perOp(c.comparisons, row.count), perOp(c.nodesVisited, row.count),
+                    perOp(c.rotations, row.count), perOp(c.insertFixupIterations + c.deleteFixupIterations, row.count),
+                    perOp(c.splits, row.count), perOp(c.merges + c.borrowsFromPrev + c.borrowsFromNext, row.count),
+                    perOp(c.successorSteps, row.count),
+            };
+            const char* counterNames[] = {"cmp_per_op", "nodes_per_op", "rotations_per_op", "fixups_per_op",
+                                          "splits_per_op", "merges_per_op", "successor_steps_per_op"};
+            // Hardware counters per operation, plus IPC; NaN where not measured.
+            const PerfCounters::Reading& p = row.perf;
+            double hardware[PerfCounters::EVENT_COUNT + 1];
+            const char* hardwareNames[] = {"cycles_per_op", "instructions_per_op", "l1d_misses_per_op",
+                                           "llc_misses_per_op", "branch_misses_per_op", "ipc"};
+            for (int event = 0; event < PerfCounters::EVENT_COUNT; ++event) {
+                hardware[event] = p.valid[event] && row.count > 0 ? p.values[event] / row.count : NAN;
+            }
+            hardware[PerfCounters::EVENT_COUNT] =
+                    p.valid[PerfCounters::CYCLES] && p.valid[PerfCounters::INSTRUCTIONS] && p.values[PerfCounters::CYCLES] > 0
+                    ? p.values[PerfCounters::INSTRUCTIONS] / p.values[PerfCounters::CYCLES] : NAN;
+            // Column order: cycles, instructions, ipc, l1d, llc, branch misses.
+            const int hardwareOrder[] = {0, 1, 5, 2, 3, 4};
+            if (json) {
+                cout << (first ? "" : ",\n") << "  {\"tree\":\"" << row.tree << "\",\"degree\":" << row.degree
+                     << ",\"distribution\":\"" << row.distribution << "\",\"n\":" << row.n << ",\"op\":\"" << row.op
+                     << "\",\"count\":" << row.count << ",\"ns_per_op\":" << row.nsPerOp << ",\"p50_ns\":" << p50
+                     << ",\"p90_ns\":" << p90 << ",\"p99_ns\":" << p99 << ",\"p999_ns\":" << p999
+                     << ",\"max_ns\":" << max << ",\"peak_rss_kb\":" << peakRssKb()
+                     << ",\"tree_rss_kb\":" << row.treeRssKb;
+                for (size_t i = 0; i < 7; ++i) {
+                    cout << ",\"" << counterNames[i] << "\":" << counters[i];
+                }
+                for (int i : hardwareOrder) {
+                    cout << ",\"" << hardwareNames[i] << "\":";
+                    if (std::isnan(hardware[i])) cout << "null";
+                    else cout << hardware[i];
+                }
+                cout << "}";
+            } else {
+                cout << row.tree << "," << row.degree << "," << row.distribution << "," << row.n << "," << row.op << ","
+                     << row.count << "," << row.nsPerOp << "," << p50 << "," << p90 << "," << p99 << "," << p999 << ","
+                     << max << "," << peakRssKb() << "," << row.treeRssKb;
+                for (double counter : counters) {
+                    cout << "," << counter;
+                }
+                for (int i : hardwareOrder) {
+                    cout << ",";
+                    if (!std::isnan(hardware[i])) cout << hardware[i];
+                }
+                cout << "\n";
+            }
+            cout.flush();
+            first = false;
+        }
+
+    private:
+        bool json;
+        bool first = true;
+
+        static uint64_t percentile(const vector<uint64_t>& sorted, double q) {
+            if (sorted.empty()) return 0;
+            size_t index = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+            return sorted[index];
+        }
+    };
+
+    // Keeps query results observable so the optimizer cannot drop the calls.
+    volatile size_t resultSink;
+
+    // Set by --perf when at least one hardware counter could be opened.
+    PerfCounters* perfCounters = nullptr;
+
+    // Times `count` calls of op(i); every stride-th call is also timed on its own. With hardware
+    // counters the calls run back to back between start() and stop() instead.
+    template <typename Op>
+    Row measure(const string& opName, size_t count, size_t samples, TreeStats& stats, Op op) {
+        stats.reset();
+        Row row;
+        row.op = opName;
+        row.count = count;
+        if (perfCounters != nullptr) {
+            auto start = chrono::steady_clock::now();
+            perfCounters->start();
+            for (size_t i = 0; i < count; ++i) {
+                op(i);
+            }
+            row.perf = perfCounters->stop();
+            double total = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            row.nsPerOp = count == 0 ? 0.0 : total / count;
+            row.counters = stats;
+            return row;
+        }
+        size_t stride = max<size_t>(1, count / max<size_t>(1, samples));
+        row.latencies.reserve(count / stride + 1);
+
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            if (i % stride == 0) {
+                auto t0 = chrono::steady_clock::now();
+                op(i);
+                auto t1 = chrono::steady_clock::now();
+                row.latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(t1 - t0).count());
+            } else {
+                op(i);
+            }
+        }
+        double total = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        row.nsPerOp = count == 0 ? 0.0 : total / count;
+        row.counters = stats;
+        return row;
+    }
+
+    // Uniform interface over the three trees. `supports*` flags mark operations the tree lacks.
+    struct BstAdapter {
+        static constexpr bool supportsSuccessor = true, supportsKth = true, supportsRange = true;
+        BSTree tree;
+
+        explicit BstAdapter(int) {}
+        static TreeStats& stats() { return BSTree::stats; }
+        void insert(int key) { tree.insert(tree.createNode(key)); }
+        bool search(int key) { return tree.search(tree.root, key) != nullptr; }
+        void erase(int key) {
+            Node* node = tree.search(tree.root, key);
+            if (node) tree.del(node);
+        }
+        int successor(int key) {
+            Node* node = tree.search(tree.root, key);
+            Node* next = node ? tree.successor(node) : nullptr;
+            return next ? next->key : -1;
+        }
+        int kth(int k) {
+            Node* node = tree.kthSmallest(k);
+            return node ? node->key : -1;
+        }
+        size_t range(int low, int high) { return tree.rangeQuery(low, high).size(); }
+    };
+
+    struct RbAdapter {
+        static constexpr bool supportsSuccessor = true, supportsKth = false, supportsRange = false;
+        RBTree tree;
+
+        explicit RbAdapter(int) {}
+        static TreeStats& stats() { return RBTree::stats; }
+        void insert(int key) { tree.RBInsert(key); }
+        bool search(int key) { return tree.search(tree.root, key) != NIL; }
+        void erase(int key) {
+            RBNode* node = tree.search(tree.root, key);
+            if (node != NIL) tree.RBDelete(node);
+        }
+        int successor(int key) {
+            RBNode* node = tree.search(tree.root, key);
+            RBNode* next = node != NIL ? tree.successor(node) : NIL;
+            return next != NIL ? next->key : -1;
+        }
+        int kth(int) { return -1; }
+        size_t range(int, int) { return 0; }
+    };
+
+    struct BTreeAdapter {
+        static constexpr bool supportsSuccessor = false, supportsKth = false, supportsRange = false;
+        BTree tree;
+
+        explicit BTreeAdapter(int degree) : tree(degree) {}
+        static TreeStats& stats() { return BTree::stats; }
+        void insert(int key) { tree.insert(key); }
+        bool search(int key) { return tree.search(key) != nullptr; }
+        void erase(int key) {
+            if (tree.search(key)) tree.deleteKey(key);
+        }
+        int successor(int) { return -1; }
+        int kth(int) { return -1; }
+        size_t range(int, int) { return 0; }
+    };
+
+    struct Workload {
+        vector<int> insertOrder;    // distinct even keys
+        vector<int> probes;         // present keys; probe + 1 is always absent
+        vector<int> deletions;      // distinct present keys
+    };
+
+    Workload makeWorkload(const string& distribution, size_t n, size_t probes, uint64_t seed) {
+        mt19937_64 rng(seed ^ (n * 0x9E3779B97F4A7C15ull));
+        Workload w;
+        w.insertOrder.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            w.insertOrder[i] = static_cast<int>(2 * i);
+        }
+        if (distribution == "reverse") {
+            reverse(w.insertOrder.begin(), w.insertOrder.end());
+        } else if (distribution != "sorted") {
+            shuffle(w.insertOrder.begin(), w.insertOrder.end(), rng);
+        }
+
+        size_t probeCount = min(probes, n);
+        w.probes.resize(probeCount);
+        if (distribution == "zipf") {
+            // Ranks index the shuffled insertion order, so the hot keys are scattered.
+            ZipfGenerator zipf(n, 0.99);
+            for (int& probe : w.probes) {
+                probe = w.insertOrder[zipf(rng)];
+            }
+        } else {
+            uniform_int_distribution<size_t> pick(0, n - 1);
+            for (int& probe : w.probes) {
+                probe = static_cast<int>(2 * pick(rng));
+            }
+            if (distribution == "sorted") sort(w.probes.begin(), w.probes.end());
+            if (distribution == "reverse") sort(w.probes.rbegin(), w.probes.rend());
+        }
+
+        w.deletions.assign(w.insertOrder.begin(), w.insertOrder.begin() + probeCount);
+        if (distribution != "sorted" && distribution != "reverse") {
+            shuffle(w.deletions.begin(), w.deletions.end(), rng);
+        }
+        return w;
+    }
+
+    template <typename Adapter>
+    void runTree(const string& name, int degree, const string& distribution, const Workload& w,
+                 const Options& options, Reporter& reporter) {
+        size_t n = w.insertOrder.size();
+        size_t probes = w.probes.size();
+        long rssBefore = currentRssKb();
+        Adapter adapter(degree);
+        size_t sink = 0;
+
+        vector<Row> rows;
+        rows.push_back(measure("insert", n, options.samples, Adapter::stats(), [&](size_t i) { adapter.insert(w.insertOrder[i]); }));
+        long treeRss = currentRssKb() - rssBefore;
+
+        rows.push_back(measure("search_hit", probes, options.samples, Adapter::stats(),
+                               [&](size_t i) { sink += adapter.search(w.probes[i]); }));
+        rows.push_back(measure("search_miss", probes, options.samples, Adapter::stats(),
+                               [&](size_t i) { sink += adapter.search(w.probes[i] + 1); }));
+        if (Adapter::supportsSuccessor) {
+            rows.push_back(measure("successor", probes, options.samples, Adapter::stats(),
+                                   [&](size_t i) { sink += adapter.successor(w.probes[i]); }));
+        }
+        if (Adapter::supportsKth) {
+            // kth is an in-order walk, linear in k, so it gets fewer queries.
+            size_t kthProbes = max<size_t>(1, probes / 100);
+            rows.push_back(measure("kth", kthProbes, options.samples, Adapter::stats(),
+                                   [&](size_t i) { sink += adapter.kth(w.probes[i] / 2 + 1); }));
+        }
+        if (Adapter::supportsRange) {
+            // About 100 keys per range.
+            rows.push_back(measure("range", probes, options.samples, Adapter::stats(),
+                                   [&](size_t i) { sink += adapter.range(w.probes[i], w.probes[i] + 198); }));
+        }
+        rows.push_back(measure("delete", w.deletions.size(), options.samples, Adapter::stats(),
+                               [&](size_t i) { adapter.erase(w.deletions[i]); }));
+
+        for (Row& row : rows) {
+            row.tree = name;
+            row.degree = degree;
+            row.distribution = distribution;
+            row.n = n;
+            row.treeRssKb = treeRss;
+            reporter.emit(row);
+        }
+        resultSink = sink;
+    }
+
+    template <typename T>
+    vector<T> parseList(const char* text) {
+        vector<T> values;
+        stringstream ss(text);
+        string item;
+        while (getline(ss, item, ',')) {
+            stringstream itemStream(item);
+            T value;
+            if (itemStream >> value) values.push_back(value);
+        }
+        return values;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "--perf") == 0) {
+                options.perf = true;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            const char* flag = argv[i];
+            const char* value = argv[++i];
+            if (strcmp(flag, "--sizes") == 0) options.sizes = parseList<size_t>(value);
+            else if (strcmp(flag, "--dists") == 0) options.distributions = parseList<string>(value);
+            else if (strcmp(flag, "--trees") == 0) options.trees = parseList<string>(value);
+            else if (strcmp(flag, "--degrees") == 0) options.degrees = parseList<int>(value);
+            else if (strcmp(flag, "--probes") == 0) options.probes = strtoull(value, nullptr, 10);
+            else if (strcmp(flag, "--samples") == 0) options.samples = strtoull(value, nullptr, 10);
+            else if (strcmp(flag, "--bst-degenerate-limit") == 0) options.bstDegenerateLimit = strtoull(value, nullptr, 10);
+            else if (strcmp(flag, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+            else if (strcmp(flag, "--format") == 0) options.json = strcmp(value, "json") == 0;
+            else return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "usage: tree_bench [--sizes a,b,..] [--dists sorted,reverse,uniform,zipf] [--trees bst,rb,btree]\n"
+                "                  [--degrees t1,t2,..] [--probes n] [--samples n] [--bst-degenerate-limit n]\n"
+                "                  [--seed n] [--format csv|json] [--perf]\n";
+        return 2;
+    }
+
+    PerfCounters counters;
+    if (options.perf) {
+        for (int event = 0; event < PerfCounters::EVENT_COUNT; ++event) {
+            if (!counters.available(static_cast<PerfCounters::Event>(event))) {
+                cerr << "perf: " << PerfCounters::name(static_cast<PerfCounters::Event>(event)) << " unavailable\n";
+            }
+        }
+        if (counters.anyAvailable()) {
+            perfCounters = &counters;
+        } else {
+            cerr << "perf: no hardware counters (Linux only; see /proc/sys/kernel/perf_event_paranoid), "
+                    "running without them\n";
+        }
+    }
+
+    Reporter reporter(options.json);
+    for (size_t n : options.sizes) {
+        if (n == 0) continue;
+        for (const string& distribution : options.distributions) {
+            Workload workload = makeWorkload(distribution, n, options.probes, options.seed);
+            for (const string& tree : options.trees) {
+                if (tree == "bst") {
+                    bool degenerate = distribution == "sorted" || distribution == "reverse";
+                    if (degenerate && n > options.bstDegenerateLimit) {
+                        cerr << "skipping bst/" << distribution << "/" << n << ": degenerate chain\n";
+                        continue;
+                    }
+                    runTree<BstAdapter>("bst", 0, distribution, workload, options, reporter);
+                } else if (tree == "rb") {
+                    runTree<RbAdapter>("rb", 0, distribution, workload, options, reporter);
+                } else if (tree == "btree") {
+                    for (int degree : options.degrees) {
+                        if (degree >= 2) {
+                            runTree<BTreeAdapter>("btree", degree, distribution, workload, options, reporter);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Durable insert throughput of DurableBTree: per-operation fsync versus group commit,
+// and the cost of checkpointing at different intervals.
+//
+// usage: wal_bench [threads=8] [opsPerThread=2000] [directory=.]
+// Prints one CSV row per configuration.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../BTreeWAL.h"
+
+using namespace std;
+
+struct BenchConfig {
+    const char* name;
+    WALSyncMode syncMode;
+    uint64_t checkpointInterval;
+};
+
+void removeFiles(const string& basePath) {
+    filesystem::remove(basePath + ".wal");
+    filesystem::remove(basePath + ".ckpt");
+    filesystem::remove(basePath + ".ckpt.tmp");
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? atoi(argv[1]) : 8;
+    int opsPerThread = argc > 2 ? atoi(argv[2]) : 2000;
+    string directory = argc > 3 ? argv[3] : ".";
+    string basePath = (filesystem::path(directory) / "wal_bench").string();
+    const int t = 32;
+
+    const BenchConfig configs[] = {
+            {"per-op-fsync", WALSyncMode::PerOperation, 0},
+            {"group-commit", WALSyncMode::GroupCommit, 0},
+            {"group-commit", WALSyncMode::GroupCommit, 100000},
+            {"group-commit", WALSyncMode::GroupCommit, 10000},
+            {"group-commit", WALSyncMode::GroupCommit, 1000},
+    };
+
+    cout << "mode,threads,ops,checkpoint_interval,seconds,ops_per_sec,fsyncs,checkpoints,recovery_ms\n";
+    for (const BenchConfig& config : configs) {
+        removeFiles(basePath);
+        WALOptions options;
+        options.syncMode = config.syncMode;
+        options.checkpointInterval = config.checkpointInterval;
+
+        WALStats stats;
+        auto start = chrono::steady_clock::now();
+        {
+            DurableBTree tree(t, basePath, options);
+            vector<thread> workers;
+            for (int w = 0; w < threads; ++w) {
+                workers.emplace_back([&tree, w, threads, opsPerThread] {
+                    for (int i = 0; i < opsPerThread; ++i) {
+                        tree.insert(i * threads + w);
+                    }
+                });
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            stats = tree.stats();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        auto recoveryStart = chrono::steady_clock::now();
+        {
+            DurableBTree recovered(t, basePath, options);
+            if (recovered.tree().keyCount() != threads * opsPerThread) {
+                cerr << "recovery lost keys in " << config.name << "\n";
+                return 1;
+            }
+        }
+        double recoveryMs = chrono::duration<double, milli>(chrono::steady_clock::now() - recoveryStart).count();
+
+        long long ops = static_cast<long long>(threads) * opsPerThread;
+        cout << config.name << "," << threads << "," << ops << "," << config.checkpointInterval << ","
+             << seconds << "," << ops / seconds << "," << stats.syncs << "," << stats.checkpoints << ","
+             << recoveryMs << "\n";
+    }
+    removeFiles(basePath);
+    return 0;
+}
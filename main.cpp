@@ -1,7 +1,12 @@
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include "BatchMode.h"
 #include "BSTOperations.h"
 #include "RBTreeOperations.h"
 #include "BTreeOperations.h"
+#include "OpLatency.h"
+#include "OpTrace.h"
 
 using namespace std;
 
@@ -10,13 +15,90 @@ void showMainMenu() {
     cout << "1. Binary Search Tree (BST)\n";
     cout << "2. Red-Black Tree (RBTree)\n";
     cout << "3. B-Tree\n";
-    cout << "4. Exit\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "4. Operation latency\n";
+    cout << "5. Exit\n";
+    cout << "Enter your choice (1-5): ";
 }
 
-int main() {
+void latencyMenu() {
     int choice = 0;
-    while (choice != 4) {
+    while (choice != 5) {
+        cout << "\n--- Operation Latency (timing is " << (OpLatency::enabled() ? "on" : "off") << ") ---\n";
+        cout << "1. Turn timing on\n";
+        cout << "2. Turn timing off\n";
+        cout << "3. Show latency percentiles\n";
+        cout << "4. Reset histograms\n";
+        cout << "5. Back to main menu\n";
+        cout << "Enter your choice (1-5): ";
+        cin >> choice;
+
+        switch (choice) {
+            case 1:
+                OpLatency::setEnabled(true);
+                break;
+            case 2:
+                OpLatency::setEnabled(false);
+                break;
+            case 3:
+                OpLatency::report(cout);
+                break;
+            case 4:
+                OpLatency::reset();
+                break;
+            case 5:
+                break;
+            default:
+                cout << "Invalid choice! Please try again.\n";
+                break;
+        }
+    }
+}
+
+void showUsage(const char* program) {
+    cerr << "usage: " << program << " [--trace path]      interactive menus\n";
+    cerr << "       " << program << " --batch [--tree bst|rb|btree] [--degree t] [--quiet] [--latency] [--trace path]"
+         << " [script|-]\n";
+}
+
+int runBatch(int argc, char** argv) {
+    BatchMode::Options options;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--tree") == 0 && i + 1 < argc) {
+            options.tree = argv[++i];
+        } else if (strcmp(argv[i], "--degree") == 0 && i + 1 < argc) {
+            options.degree = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            options.quiet = true;
+        } else if (strcmp(argv[i], "--latency") == 0) {
+            options.latency = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            options.scriptPath = argv[i];
+        } else {
+            showUsage(argv[0]);
+            return 2;
+        }
+    }
+    return BatchMode::run(options);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "--batch") == 0)
+            return runBatch(argc, argv);
+        if (argc != 3 || strcmp(argv[1], "--trace") != 0) {
+            showUsage(argv[0]);
+            return 2;
+        }
+        if (!OpTrace::start(argv[2])) {
+            cerr << "cannot create trace '" << argv[2] << "'\n";
+            return 1;
+        }
+    }
+
+    int choice = 0;
+    while (choice != 5) {
         showMainMenu();
         cin >> choice;
 
@@ -31,6 +113,9 @@ int main() {
                 bTreeMenu();
                 break;
             case 4:
+                latencyMenu();
+                break;
+            case 5:
                 cout << "Exiting... Goodbye!" << endl;
                 break;
             default:
@@ -38,5 +123,9 @@ int main() {
                 break;
         }
     }
+    if (!OpTrace::stop()) {
+        cerr << "cannot write the trace\n";
+        return 1;
+    }
     return 0;
 }
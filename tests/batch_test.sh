@@ -0,0 +1,38 @@
+#!/bin/sh
+# Batch mode regression checks: runs scripts through ./ads --batch and compares stdout and the
+# exit status with what is expected.
+#
+# usage: tests/batch_test.sh [path to ads=./ads]
+
+ADS=${1:-./ads}
+failures=0
+
+# check <name> <script> <expected stdout> <expected status> [ads arguments...]
+check() {
+    name=$1
+    script=$2
+    expected=$3
+    expectedStatus=$4
+    shift 4
+    actual=$(printf "$script" | "$ADS" --batch "$@" 2>/dev/null)
+    status=$?
+    if [ "$actual" != "$expected" ] || [ "$status" -ne "$expectedStatus" ]; then
+        echo "FAIL $name: status $status, output:"
+        echo "$actual"
+        failures=$((failures + 1))
+    else
+        echo "ok   $name"
+    fi
+}
+
+# A rejected tree line keeps the current tree and its keys.
+check "unknown tree name" 'insert 1 2 3\ntree foo\nsearch 1 4\ncount\n' "1 0
+3" 1
+check "B-Tree degree below 2" 'insert 5 6\ntree btree 1\ninsert 7\nsearch 5 7\n' "1 1" 1 --tree rb
+check "extra tree argument" 'tree btree 3 4\ninsert 8\nsearch 8\n' "1" 1 --tree btree
+
+# A valid tree line starts an empty tree of the new kind.
+check "tree switch" 'insert 1 2\ntree btree 2\nsearch 1\ninsert 9\nkth 1\n' "0
+9" 0
+
+[ "$failures" -eq 0 ]